@@ -0,0 +1,49 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Compara los kernels de Spiral/Nebula (scalar vs sse vs avx2) en --headless.
+# Uso: ./example/bench_kernels.sh [N] [ANCHOxALTO] [FRAMES] [HILOS]
+# Ejemplo:
+#   ./example/bench_kernels.sh 200000 1920x1080 300 1
+
+N="${1:-200000}"
+RES="${2:-1920x1080}"
+FRAMES="${3:-300}"
+THREADS="${4:-1}"
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+BUILD_DIR="$PROJECT_ROOT/build"
+BENCH_DIR="$PROJECT_ROOT/bench"
+
+mkdir -p "$BUILD_DIR" "$BENCH_DIR"
+TS="$(date +%Y%m%d_%H%M%S)"
+
+echo "Compilando…"
+cmake -S "$PROJECT_ROOT" -B "$BUILD_DIR" -DCMAKE_BUILD_TYPE=Release >/dev/null
+cmake --build "$BUILD_DIR" -j >/dev/null
+
+KERNELS=(scalar sse avx2)
+for mode in spiral nebula; do
+  for k in "${KERNELS[@]}"; do
+    echo ">> $mode :: --kernel $k"
+    (cd "$PROJECT_ROOT" && "$BUILD_DIR/matrix_screensaver" "$N" "$RES" --mode "$mode" \
+        --headless --bench-frames "$FRAMES" --threads "$THREADS" --kernel "$k" \
+        --bench "$BENCH_DIR/kernel_${k}_${TS}.csv" >/dev/null)
+  done
+done
+
+# Promedio de update_ms (col 11) por modo, descartando los 10 primeros frames
+avg() {
+  awk -F, -v m="$2" 'NR>1 && $2==m && $9>=10 { s+=$11; n++ } END { if (n) printf "%.3f", s/n; else printf "-" }' "$1"
+}
+
+printf "\n%-8s %-7s %12s %9s\n" mode kernel update_ms speedup
+for mode in spiral nebula; do
+  base="$(avg "$BENCH_DIR/kernel_scalar_${TS}.csv" "$mode")"
+  for k in "${KERNELS[@]}"; do
+    t="$(avg "$BENCH_DIR/kernel_${k}_${TS}.csv" "$mode")"
+    printf "%-8s %-7s %12s %9s\n" "$mode" "$k" "$t" \
+      "$(awk -v a="$base" -v b="$t" 'BEGIN { if (b > 0) printf "%.2fx", a/b; else print "-" }')"
+  done
+done
@@ -0,0 +1,60 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Compara update_ms sin fijar hilos y con --pin compact / scatter, en modo
+# --headless (sin render ni vsync) con N=200000 (maximo CLI). En maquinas con
+# varios nodos NUMA, scatter reparte el equipo entre nodos y la init en
+# paralelo deja cada tramo de particulas en el nodo del hilo que lo actualiza.
+# Uso: ./example/bench_pin.sh [N] [ANCHOxALTO] [FRAMES] [HILOS]
+# Ejemplo:
+#   ./example/bench_pin.sh 200000 1920x1080 300 32
+
+N="${1:-200000}"
+RES="${2:-1920x1080}"
+FRAMES="${3:-300}"
+THREADS="${4:-$(nproc)}"
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+BIN="$PROJECT_ROOT/build/matrix_screensaver"
+BENCH_DIR="$PROJECT_ROOT/bench"
+
+if [[ ! -x "$BIN" ]]; then
+  echo "Compilando…"
+  cmake -S "$PROJECT_ROOT" -B "$PROJECT_ROOT/build" -DCMAKE_BUILD_TYPE=Release >/dev/null
+  cmake --build "$PROJECT_ROOT/build" -j >/dev/null
+fi
+
+if command -v lscpu >/dev/null; then
+  lscpu | grep -E "^(Model name|Socket\(s\)|NUMA node\(s\)|NUMA node[0-9]+ CPU)" || true
+fi
+
+mkdir -p "$BENCH_DIR"
+TS="$(date +%Y%m%d_%H%M%S)"
+PINS=(none compact scatter)
+
+for pin in "${PINS[@]}"; do
+  csv="$BENCH_DIR/pin_${pin}_${TS}.csv"
+  for mode in bounce spiral nebula; do
+    echo ">> $mode --pin $pin"
+    # Los assets se buscan relativos al cwd: siempre desde la raiz
+    (cd "$PROJECT_ROOT" && "$BIN" "$N" "$RES" --mode "$mode" --headless --seed 1 \
+        --bench-frames "$FRAMES" --threads "$THREADS" --pin "$pin" --bench "$csv" \
+        | grep -E "^\[pin\]" || true)
+  done
+done
+
+# Promedio de update_ms (col 11) por modo, descartando los 10 primeros frames
+avg() {
+  awk -F, -v m="$2" 'NR>1 && $2==m && $9>=10 { s+=$11; n++ } END { if (n) printf "%.3f", s/n; else printf "-" }' "$1"
+}
+
+printf "\n%-8s %12s %12s %12s %9s %9s\n" mode none_ms compact_ms scatter_ms compact scatter
+for mode in bounce spiral nebula; do
+  a="$(avg "$BENCH_DIR/pin_none_${TS}.csv" "$mode")"
+  c="$(avg "$BENCH_DIR/pin_compact_${TS}.csv" "$mode")"
+  s="$(avg "$BENCH_DIR/pin_scatter_${TS}.csv" "$mode")"
+  ratio() { awk -v a="$1" -v b="$2" 'BEGIN { if (b > 0) printf "%.2fx", a/b; else print "-" }'; }
+  printf "%-8s %12s %12s %12s %9s %9s\n" "$mode" "$a" "$c" "$s" "$(ratio "$a" "$c")" "$(ratio "$a" "$s")"
+done
+echo "CSV: $BENCH_DIR/pin_{none,compact,scatter}_${TS}.csv"
@@ -0,0 +1,65 @@
+#!/usr/bin/env bash
+set -euo pipefail
+
+# Compara update_ms de Bounce/Spiral/Nebula antes y despues del almacen SoA de
+# particulas, en modo --headless (sin render ni vsync) con N=200000 (maximo CLI).
+# "Antes" se compila desde BASE_REF en un worktree temporal.
+# Uso: ./example/bench_soa.sh [N] [ANCHOxALTO] [FRAMES] [HILOS]
+# Ejemplo:
+#   BASE_REF=<commit-previo> ./example/bench_soa.sh 200000 1920x1080 300 8
+
+N="${1:-200000}"
+RES="${2:-1920x1080}"
+FRAMES="${3:-300}"
+THREADS="${4:-$(nproc)}"
+
+SCRIPT_DIR="$(cd "$(dirname "${BASH_SOURCE[0]}")" && pwd)"
+PROJECT_ROOT="$(dirname "$SCRIPT_DIR")"
+BENCH_DIR="$PROJECT_ROOT/bench"
+
+# Por defecto: el padre del commit que introdujo ParticleStore.h
+BASE_REF="${BASE_REF:-$(git -C "$PROJECT_ROOT" log --format=%H --diff-filter=A -1 -- include/ParticleStore.h)^}"
+BASE_DIR="$(mktemp -d)"
+trap 'git -C "$PROJECT_ROOT" worktree remove --force "$BASE_DIR" >/dev/null 2>&1 || true' EXIT
+
+mkdir -p "$BENCH_DIR"
+TS="$(date +%Y%m%d_%H%M%S)"
+CSV_AOS="$BENCH_DIR/soa_before_${TS}.csv"
+CSV_SOA="$BENCH_DIR/soa_after_${TS}.csv"
+
+build() {
+  local src="$1"
+  cmake -S "$src" -B "$src/build" -DCMAKE_BUILD_TYPE=Release >/dev/null
+  cmake --build "$src/build" -j >/dev/null
+}
+
+echo "Compilando antes ($BASE_REF) y despues…"
+git -C "$PROJECT_ROOT" worktree add --detach "$BASE_DIR" "$BASE_REF" >/dev/null
+build "$BASE_DIR"
+build "$PROJECT_ROOT"
+
+run() {
+  local bin="$1" csv="$2" mode="$3"
+  # Los assets se buscan relativos al cwd: siempre desde la raiz actual
+  (cd "$PROJECT_ROOT" && "$bin" "$N" "$RES" --mode "$mode" --headless \
+      --bench-frames "$FRAMES" --threads "$THREADS" --bench "$csv" >/dev/null)
+}
+
+for mode in bounce spiral nebula; do
+  echo ">> $mode"
+  run "$BASE_DIR/build/matrix_screensaver" "$CSV_AOS" "$mode"
+  run "$PROJECT_ROOT/build/matrix_screensaver" "$CSV_SOA" "$mode"
+done
+
+# Promedio de update_ms (col 11) por modo, descartando los 10 primeros frames
+avg() {
+  awk -F, -v m="$2" 'NR>1 && $2==m && $9>=10 { s+=$11; n++ } END { if (n) printf "%.3f", s/n; else printf "-" }' "$1"
+}
+
+printf "\n%-8s %14s %14s %8s\n" mode aos_update_ms soa_update_ms speedup
+for mode in bounce spiral nebula; do
+  a="$(avg "$CSV_AOS" "$mode")"; b="$(avg "$CSV_SOA" "$mode")"
+  printf "%-8s %14s %14s %8s\n" "$mode" "$a" "$b" \
+    "$(awk -v a="$a" -v b="$b" 'BEGIN { if (b > 0) printf "%.2fx", a/b; else print "-" }')"
+done
+echo "CSV: $CSV_AOS $CSV_SOA"
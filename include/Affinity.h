@@ -0,0 +1,29 @@
+#pragma once
+#include <string>
+#include <thread>
+#include <vector>
+
+// Afinidad de hilos (--pin). La ranura t de un equipo (hilo OpenMP t, hilo t
+// del pool) va a la CPU order[t % order.size()]:
+//   Compact -> CPUs vecinas primero (hermanos SMT, luego nucleos del mismo nodo)
+//   Scatter -> un nucleo de cada nodo NUMA por turno, los hermanos SMT al final
+//   List    -> la lista dada ("0,2,4-7"), en ese orden
+// Solo Linux (sysfs + sched_setaffinity); en otros sistemas no se fija nada.
+enum class PinMode { None, Compact, Scatter, List };
+
+struct PinSpec {
+    PinMode mode = PinMode::None;
+    std::vector<int> cpus;  // solo List
+};
+
+const char* pinModeName(PinMode m);
+
+// "compact" | "scatter" | "none" | lista de CPUs y rangos. false si no se entiende.
+bool parsePinSpec(const std::string& s, PinSpec& out);
+
+// CPUs por ranura, dentro de las permitidas al proceso (vacio = no fijar)
+std::vector<int> pinOrder(const PinSpec& spec);
+
+// Fija el hilo actual / un std::thread a una CPU. false si el sistema lo rechaza.
+bool pinCurrentThread(int cpu);
+bool pinThread(std::thread& t, int cpu);
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Columnas de --bench que cambian por frame. Se copian tal cual al anillo: el
+// texto lo formatea el hilo escritor.
+struct BenchRecord {
+    int frame = 0;
+    float dt = 0.f;
+    double update_ms = 0.0, render_ms = 0.0, total_ms = 0.0, fps = 0.0;
+    double forkjoin_ms = 0.0, stall_ms = 0.0;
+    int sim_steps = 0;
+    double work_ewma_ms = 0.0;
+    float detail = 1.f;
+    int threads_cap = 0;
+    const char* budget_event = "-";  // literal: vida estatica
+    double busy_max_ms = 0.0, busy_mean_ms = 0.0, imbalance = 1.0, barrier_ms = 0.0;
+    double log_ms = 0.0;             // coste de registrar el frame anterior en el bucle
+};
+
+// CSV de benchmark fuera del bucle medido: push() copia el registro a un
+// anillo preasignado (un productor, un consumidor) y un hilo escritor lo
+// formatea y escribe por bloques. Con el anillo lleno push() espera a que el
+// escritor libere sitio; las esperas se cuentan y entran en log_ms.
+class BenchLog {
+public:
+    static constexpr std::size_t kDefaultCapacity = std::size_t(1) << 14;
+
+    BenchLog() = default;
+    ~BenchLog();
+    BenchLog(const BenchLog&) = delete;
+    BenchLog& operator=(const BenchLog&) = delete;
+
+    // header: se escribe si el fichero es nuevo; si ya existe con otra
+    // cabecera, no se anade y devuelve false. prefix: columnas fijas de la
+    // ejecucion (exec..speed), sin la coma final. capacity: potencia de 2.
+    bool open(const std::string& path, const std::string& header, std::string prefix,
+              std::size_t capacity = kDefaultCapacity);
+    bool isOpen() const { return out_.is_open(); }
+
+    // Hilo del bucle: sin formato ni E/S
+    void push(const BenchRecord& r);
+
+    // Vacia el anillo, une el escritor y cierra el fichero
+    void close();
+
+    std::uint64_t rows() const { return pushed_; }
+    std::uint64_t fullWaits() const { return fullWaits_; }
+    double writerMs() const { return writerMs_; }  // tiempo del escritor (formato + escritura)
+
+private:
+    std::vector<BenchRecord> ring_;
+    std::size_t mask_ = 0;
+    std::atomic<std::uint64_t> head_{0};  // siguiente a escribir (productor)
+    std::atomic<std::uint64_t> tail_{0};  // siguiente a formatear (escritor)
+    std::ofstream out_;
+    std::string prefix_;
+
+    std::thread writer_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    bool stop_ = false;
+
+    std::uint64_t pushed_ = 0, fullWaits_ = 0;
+    double writerMs_ = 0.0;
+
+    void writerLoop();
+    bool drain(std::string& buf);
+};
@@ -0,0 +1,65 @@
+#pragma once
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+
+// Generador basado en contador (SplitMix64): el valor n de un flujo es una
+// funcion pura de (clave, n), sin estado compartido entre hilos. Cada elemento
+// de la escena deriva su clave de (semilla, dominio, indice), asi que lo que
+// genera no depende del orden ni del numero de hilos que lo inicialicen.
+
+inline std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ull;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+    return x ^ (x >> 31);
+}
+
+// Semilla de --seed: decimal, o hexadecimal solo con prefijo 0x/0X (un 0
+// inicial no es octal: "010" = 10). Vacio, signo, texto o mas de 64 bits no valen.
+inline bool parseSeed(const char* s, std::uint64_t& seed) {
+    if (!s) return false;
+    int base = 10;
+    if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) { base = 16; s += 2; }
+    if (base == 10 ? !std::isdigit((unsigned char)s[0]) : !std::isxdigit((unsigned char)s[0]))
+        return false;
+    char* end = nullptr;
+    errno = 0;
+    const unsigned long long v = std::strtoull(s, &end, base);
+    if (errno == ERANGE || *end != '\0') return false;
+    seed = v;
+    return true;
+}
+
+// Dominios separados: la particula i y la gota i no comparten flujo
+enum class RngDomain : std::uint32_t { Particle = 1, Color, Rain, Dash, Model };
+
+class CounterRng {
+public:
+    CounterRng(std::uint64_t seed, RngDomain domain, std::uint64_t index)
+        : key_(splitmix64(splitmix64(seed ^ (std::uint64_t(domain) << 56)) ^ index)) {}
+
+    // Valor n del flujo (no avanza el contador)
+    std::uint64_t at(std::uint64_t n) const {
+        return splitmix64(key_ + n * 0x9E3779B97F4A7C15ull);
+    }
+    std::uint64_t next() { return at(ctr_++); }
+    // Salta a la posicion n (reanudar un flujo en otra pasada o en otro hilo)
+    void seek(std::uint64_t n) { ctr_ = n; }
+
+    // [a, b) con 24 bits de mantisa
+    float uniform(float a, float b) {
+        return a + (b - a) * (float(next() >> 40) * (1.0f / 16777216.0f));
+    }
+    // [0, n) sin sesgo apreciable (multiplicacion de 32x32 bits)
+    std::uint32_t below(std::uint32_t n) {
+        return std::uint32_t(((next() >> 32) * n) >> 32);
+    }
+    bool coin() { return (next() >> 63) != 0; }
+    float sign() { return coin() ? 1.f : -1.f; }
+
+private:
+    std::uint64_t key_;
+    std::uint64_t ctr_ = 0;
+};
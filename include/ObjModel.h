@@ -18,7 +18,14 @@ public:
                        float angleY,
                        sf::Color color);
 
+    // Rotacion Y y proyeccion de drawProjected sin dibujar (deja el resultado
+    // en projected()); drawProjected la llama antes de armar las lineas.
+    void project(sf::Vector2f center, float scale, float angleY);
+    const std::vector<sf::Vector2f>& projected() const { return vtx2d_; }
+
     bool loaded() const { return loaded_; }
+    std::size_t vertexCount() const { return vertices_.size(); }
+    std::size_t edgeCount() const { return edges_.size(); }
 
 private:
     struct Vec3 { float x, y, z; };
@@ -0,0 +1,96 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "WorkPool.h"
+
+// Backend de los bucles paralelos de TextRender/SpatialGrid (--backend):
+//   Omp    -> una region "omp parallel" por despacho (equipo del runtime)
+//   Pool   -> trabajos en WorkPool (std::thread con robo de trabajo)
+//   Serial -> todo en el hilo llamador (linea base, --seq)
+enum class Backend { Omp, Pool, Serial };
+
+// Etiqueta de la columna exec del CSV (Serial = "seq", la de analyze_bench)
+const char* backendName(Backend b);
+
+// Tramo [b, e) de la parte p de parts sobre [0, n): reparto estatico exacto
+// por elementos (el mismo en cualquier backend)
+inline void partRange(std::size_t n, int p, int parts, std::size_t& b, std::size_t& e) {
+    b = n * std::size_t(p) / std::size_t(parts);
+    e = n * std::size_t(p + 1) / std::size_t(parts);
+}
+
+// Reparto dinamico: cada parte toma el siguiente bloque libre de chunk elementos
+class ChunkCounter {
+public:
+    ChunkCounter(std::size_t n, std::size_t chunk)
+        : n_(n), chunk_(std::max<std::size_t>(1, chunk)) {}
+
+    bool next(std::size_t& b, std::size_t& e) {
+        b = next_.fetch_add(chunk_, std::memory_order_relaxed);
+        if (b >= n_) return false;
+        e = std::min(n_, b + chunk_);
+        return true;
+    }
+
+private:
+    std::atomic<std::size_t> next_{0};
+    std::size_t n_, chunk_;
+};
+
+class ParallelBackend {
+public:
+    using PartFn = std::function<void(int part)>;
+
+    virtual ~ParallelBackend() = default;
+    virtual Backend kind() const = 0;
+
+    // Partes por defecto de un despacho (hilos que puede usar a la vez)
+    virtual int threads() const = 0;
+
+    // Llama f(p) para cada p en [0, parts), en paralelo segun el backend, y
+    // vuelve cuando terminan todas (parts = 1: directo en el llamador). Sin
+    // barreras entre partes: las fases que dependen unas de otras son
+    // despachos separados. Devuelve cuantos hilos ejecutaron el despacho (el
+    // equipo real: puede ser menor que parts).
+    virtual int run(int parts, const PartFn& f) = 0;
+
+    // --pin: el hilo t del equipo (el que ejecuta la parte t) va a
+    // cpus[t % cpus.size()]. Con OpenMP fija el equipo del hilo que llama (las
+    // ICV y el equipo son por hilo). Devuelve cuantos hilos quedaron fijados.
+    virtual int pin(const std::vector<int>& cpus) = 0;
+
+    // Tope de partes por despacho (0 = sin tope): lo baja el controlador de
+    // presupuesto de frame cuando hay menos nucleos libres
+    void setPartsCap(int cap) { cap_ = std::max(0, cap); }
+    int partsCap() const { return cap_; }
+
+    // Partes para n elementos con al menos grain por parte (1 = en el llamador)
+    int partsFor(std::size_t n, std::size_t grain) const {
+        const std::size_t byGrain = n / std::max<std::size_t>(1, grain);
+        int maxParts = std::max(1, threads());
+        if (cap_ > 0) maxParts = std::min(maxParts, cap_);
+        return int(std::clamp<std::size_t>(byGrain, 1, std::size_t(maxParts)));
+    }
+
+    // Bucle estatico sobre [0, n): f(b, e) una vez por parte no vacia
+    template <class F>
+    int forStatic(std::size_t n, F&& f, std::size_t grain = 1) {
+        const int parts = partsFor(n, grain);
+        return run(parts, [&](int p) {
+            std::size_t b, e;
+            partRange(n, p, parts, b, e);
+            if (b < e) f(b, e);
+        });
+    }
+
+private:
+    int cap_ = 0;
+};
+
+// pool: obligatorio con Backend::Pool (no pasa a ser su dueno). Sin OpenMP en la
+// compilacion, Omp cae en Serial.
+std::unique_ptr<ParallelBackend> makeParallelBackend(Backend kind, WorkPool* pool);
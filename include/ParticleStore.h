@@ -0,0 +1,97 @@
+#pragma once
+#include <algorithm>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <initializer_list>
+
+// Asignador alineado (64 B = linea de cache, cubre AVX/AVX-512) que NO inicializa
+// al hacer resize(): el primer toque de cada pagina lo hace el bucle que llena el
+// arreglo, no el constructor del vector.
+template <class T, std::size_t Align = 64>
+struct AlignedAllocator {
+    using value_type = T;
+    template <class U> struct rebind { using other = AlignedAllocator<U, Align>; };
+
+    AlignedAllocator() noexcept = default;
+    template <class U> AlignedAllocator(const AlignedAllocator<U, Align>&) noexcept {}
+
+    T* allocate(std::size_t n) {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(Align)));
+    }
+    void deallocate(T* p, std::size_t) noexcept {
+        ::operator delete(p, std::align_val_t(Align));
+    }
+
+    // Inicializacion por defecto (no a cero) para tipos triviales
+    template <class U>
+    void construct(U* p) noexcept(std::is_nothrow_default_constructible<U>::value) {
+        ::new (static_cast<void*>(p)) U;
+    }
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args) {
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class U> bool operator==(const AlignedAllocator<U, Align>&) const noexcept { return true; }
+    template <class U> bool operator!=(const AlignedAllocator<U, Align>&) const noexcept { return false; }
+};
+
+template <class T> using AlignedVec = std::vector<T, AlignedAllocator<T>>;
+
+// Estado de simulacion de Bounce/Spiral/Nebula como estructura de arreglos:
+// cada bucle de update recorre solo los campos que usa, de forma contigua.
+struct ParticleStore {
+    AlignedVec<float> posX, posY, velX, velY;
+    AlignedVec<float> baseSize;
+
+    // Spiral
+    AlignedVec<float> angle, angVel, baseRadius, radiusAmp, z, zVel, phase;
+
+    // Nebula
+    AlignedVec<float> spinDeg, spinVelDeg, scale, scaleVel, alpha, alphaVel, noiseSeed;
+
+    std::size_t size() const { return posX.size(); }
+
+    void resize(std::size_t n) {
+        for (AlignedVec<float>* a : { &posX, &posY, &velX, &velY, &baseSize,
+                                      &angle, &angVel, &baseRadius, &radiusAmp, &z, &zVel, &phase,
+                                      &spinDeg, &spinVelDeg, &scale, &scaleVel, &alpha, &alphaVel,
+                                      &noiseSeed })
+            a->resize(n);
+    }
+};
+
+// Lo que el render necesita por particula: lo escribe update, lo lee render.
+struct ParticleView {
+    AlignedVec<float> x, y;          // posicion en pantalla
+    AlignedVec<float> prevX, prevY;  // posicion antes del ultimo paso (interpolacion)
+    AlignedVec<float> rot, scale;    // grados / escala uniforme (Nebula)
+    AlignedVec<float> charSize;      // tamano de caracter (Bounce/Spiral)
+    AlignedVec<std::uint32_t> rgba;  // color empaquetado como sf::Color::toInteger()
+    std::vector<char> ch;            // caracter (fijo desde init)
+
+    std::size_t size() const { return x.size(); }
+
+    void resize(std::size_t n) {
+        x.resize(n); y.resize(n); prevX.resize(n); prevY.resize(n); rot.resize(n); scale.resize(n);
+        charSize.resize(n); rgba.resize(n); ch.resize(n);
+    }
+
+    // Copia [b, e) de o (mismo tamano): para llenar una vista por tramos en
+    // paralelo en vez de copiarla entera desde un hilo
+    void copyRange(const ParticleView& o, std::size_t b, std::size_t e) {
+        std::copy(o.x.begin() + b, o.x.begin() + e, x.begin() + b);
+        std::copy(o.y.begin() + b, o.y.begin() + e, y.begin() + b);
+        std::copy(o.prevX.begin() + b, o.prevX.begin() + e, prevX.begin() + b);
+        std::copy(o.prevY.begin() + b, o.prevY.begin() + e, prevY.begin() + b);
+        std::copy(o.rot.begin() + b, o.rot.begin() + e, rot.begin() + b);
+        std::copy(o.scale.begin() + b, o.scale.begin() + e, scale.begin() + b);
+        std::copy(o.charSize.begin() + b, o.charSize.begin() + e, charSize.begin() + b);
+        std::copy(o.rgba.begin() + b, o.rgba.begin() + e, rgba.begin() + b);
+        std::copy(o.ch.begin() + b, o.ch.begin() + e, ch.begin() + b);
+    }
+};
@@ -0,0 +1,59 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Kernels vectorizados de Spiral y Nebula sobre el almacen SoA (ParticleStore).
+// Cada ISA procesa 2 vectores por iteracion: SSE4.1 = 8 particulas, AVX2 = 16.
+// La cola (< 2 vectores) usa el mismo algoritmo en escalar.
+//
+// sin/cos: reduccion de Cody-Waite a [-pi/4, pi/4] con pi/2 en 3 partes y
+// polinomios minimax de grado 7 (sin) y 8 (cos) (coeficientes de Cephes sinf/cosf).
+// Error absoluto medido contra sin/cos en double (4e6 muestras por rango):
+//   |x| <= 8192  : <= 9.3e-8 en todas las rutas (~1.5 ulp cerca de 1)
+//   |x| <= 65536 : <= 9.3e-8 con FMA (AVX2); sin FMA (SSE4.1) 2.6e-7 hasta
+//                  16384 y 9.6e-7 hasta 65536 (la reduccion pierde exactitud)
+// Mas alla crece linealmente con |x|. Los argumentos son angulos que crecen
+// ~1.6 rad/s y 0.7*t: |x| = 8192 tras ~85 min de ejecucion continua.
+
+enum class SimdKernel { Scalar, Sse41, Avx2, Auto };
+
+struct SpiralKernelArgs {
+    float* angle; const float* angVel;
+    const float* baseRadius; const float* radiusAmp; const float* phase;
+    float* z; float* zVel;
+    const float* baseSize;
+    float* outX; float* outY; float* outCharSize; std::uint32_t* outRgba;
+    float cx, cy, dt;
+};
+
+struct NebulaKernelArgs {
+    float* posX; float* posY; float* velX; float* velY;
+    float* spinDeg; const float* spinVelDeg;
+    float* scale; float* scaleVel;
+    float* alpha; float* alphaVel;
+    const float* noiseSeed;
+    float* outX; float* outY; float* outRot; float* outScale; std::uint32_t* outRgba;
+    float time, dt, vmax;
+};
+
+using SpiralKernelFn = void (*)(const SpiralKernelArgs&, std::size_t begin, std::size_t end);
+using NebulaKernelFn = void (*)(const NebulaKernelArgs&, std::size_t begin, std::size_t end);
+
+struct SimdKernelSet {
+    SimdKernel kind = SimdKernel::Scalar;
+    SpiralKernelFn spiral = nullptr;   // nullptr = ruta escalar de TextRender
+    NebulaKernelFn nebula = nullptr;
+};
+
+// Resuelve la peticion contra la CPU actual (cpuid). Si la ISA pedida no esta
+// disponible cae a la mejor inferior; Scalar devuelve punteros nulos.
+SimdKernelSet resolveSimdKernels(SimdKernel requested);
+const char* simdKernelName(SimdKernel k);
+
+// Implementaciones por ISA (cada una en su TU con sus flags de compilacion)
+#if defined(MATRIX_SIMD_X86)
+void spiralKernelSse41(const SpiralKernelArgs& a, std::size_t begin, std::size_t end);
+void nebulaKernelSse41(const NebulaKernelArgs& a, std::size_t begin, std::size_t end);
+void spiralKernelAvx2(const SpiralKernelArgs& a, std::size_t begin, std::size_t end);
+void nebulaKernelAvx2(const NebulaKernelArgs& a, std::size_t begin, std::size_t end);
+#endif
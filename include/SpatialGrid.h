@@ -0,0 +1,41 @@
+#pragma once
+#include <SFML/Graphics.hpp>
+#include <vector>
+#include <cstddef>
+#include "Parallel.h"
+
+// Rejilla uniforme reconstruida cada frame con un counting sort paralelo:
+//   1) cada parte cuenta su tramo estatico de particulas por celda,
+//   2) prefijo por (celda, parte) -> desplazamientos,
+//   3) cada parte dispersa su tramo en order().
+// El orden resultante es estable (igual para cualquier numero de hilos).
+class SpatialGrid {
+public:
+    // x/y: posiciones; cellSize >= diametro de interaccion; world en pixeles.
+    // Fases como despachos de par en parts partes (1 = en el llamador);
+    // team recibe los hilos del conteo.
+    void build(const float* x, const float* y, int n, float cellSize,
+               sf::Vector2u world, ParallelBackend& par, int parts, int& team);
+
+    int cols() const { return cols_; }
+    int rows() const { return rows_; }
+    float cellSize() const { return cell_; }
+
+    int cellX(float x) const;
+    int cellY(float y) const;
+
+    // Particulas de la celda c: order()[cellStart()[c] .. cellStart()[c+1])
+    const int* cellStart() const { return start_.data(); }
+    const int* order() const { return order_.data(); }
+
+private:
+    float cell_ = 1.f;
+    float inv_  = 1.f;
+    int cols_ = 1;
+    int rows_ = 1;
+
+    std::vector<int> cellOf_;  // celda de cada particula
+    std::vector<int> start_;   // cells + 1
+    std::vector<int> order_;   // indices ordenados por celda
+    std::vector<int> hist_;    // partes x celdas (contadores y luego desplazamientos)
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "WorkPool.h"
+
+// Grafo de tareas de un frame. Cada tarea declara sus dependencias (tareas ya
+// anadidas) y un rango [0, n) que se parte en subtareas de grain elementos;
+// cuando termina su ultima subtarea se liberan las que dependen de ella.
+// run() ejecuta el grafo en un WorkPool y deja tiempos por tarea. El grafo se
+// arma una vez y se ejecuta cada frame (los cuerpos leen su estado al correr).
+class TaskGraph {
+public:
+    using Body = std::function<void(std::size_t begin, std::size_t end)>;
+
+    struct Stats {
+        double startMs = 0.0;   // primera subtarea, desde el inicio de run()
+        double endMs   = 0.0;   // ultima subtarea
+        double busyMs  = 0.0;   // suma de las subtareas (trabajo total)
+        int    chunks  = 0;
+        int    workers = 0;     // hilos distintos que ejecutaron subtareas
+        bool   critical = false; // en la ruta critica (cadena de mayor duracion)
+    };
+
+    // Devuelve el id de la tarea. deps: ids anteriores. n = 1: tarea unica.
+    int add(const char* name, Body body, std::vector<int> deps = {},
+            std::size_t n = 1, std::size_t grain = 1);
+    void clear();
+
+    void run(WorkPool& pool);
+
+    int size() const { return int(nodes_.size()); }
+    const char* name(int id) const { return nodes_[id]->name; }
+    const std::vector<int>& deps(int id) const { return nodes_[id]->deps; }
+    const Stats& stats(int id) const { return nodes_[id]->stats; }
+    double makespanMs() const { return makespanMs_; }
+    double criticalPathMs() const { return criticalMs_; }
+
+    // "a, b -> c; b -> d": aristas de dependencia (tareas sueltas por su nombre)
+    std::string describe() const;
+
+private:
+    struct Node {
+        const char* name;
+        Body body;
+        std::vector<int> deps;
+        std::vector<int> succ;
+        std::size_t n = 1, grain = 1;
+        int firstChunk = 0, nChunks = 1;
+        std::atomic<int> depsLeft{0};
+        std::atomic<int> chunksLeft{0};
+        Stats stats;
+    };
+    struct Chunk {
+        int node = 0;
+        std::size_t begin = 0, end = 0;
+        double t0 = 0.0, t1 = 0.0;
+        int worker = 0;
+    };
+
+    std::vector<std::unique_ptr<Node>> nodes_;
+    std::vector<Chunk> chunks_;
+    std::atomic<int> remaining_{0};
+    WorkPool* pool_ = nullptr;
+    double origin_ = 0.0;
+    double makespanMs_ = 0.0;
+    double criticalMs_ = 0.0;
+
+    void release(int id);
+    static void runChunk(void* ctx, std::size_t chunk, int worker);
+    void finishStats();
+};
@@ -1,15 +1,71 @@
 #pragma once
 #include <SFML/Graphics.hpp>
 #include <vector>
-#include <random>
+#include <cstdint>
+#include <array>
 #include <string>
 #include <memory>
 #include "ObjModel.h"
+#include "CounterRng.h"
+#include "Parallel.h"
+#include "ParticleStore.h"
+#include "SimdKernels.h"
+#include "SpatialGrid.h"
+#include "TaskGraph.h"
+#include "WorkPool.h"
 
 // Modos
 enum class MotionMode { Bounce, Spiral, Rain, Nebula };
 enum class Palette    { Mono, Neon, Rainbow };
 
+// Regiones paralelas de update (auto-chequeo de hilos y metricas)
+enum class ParSite { RainCols,
+                     DashMove, DashDots, Particles,
+                     GridBuild, Collide, RainFill, Count };
+const char* parSiteName(ParSite s);
+
+// Opciones de construccion que no cambian la escena (se amplian sin tocar el ctor)
+struct RenderConfig {
+    // Sin ventana ni contexto GL: las metricas de glifo se estiman en vez de
+    // pedirlas a sf::Font (que rasteriza en una textura y exige contexto).
+    bool headless = false;
+
+    // Rain: todos los glifos y puntos como quads en un solo sf::VertexArray
+    // (1 draw call). false = un window.draw por sf::Text (ruta original).
+    bool batchRain = true;
+
+    // Spiral/Nebula: kernel vectorizado (Auto = mejor ISA disponible) o escalar
+    SimdKernel kernel = SimdKernel::Auto;
+
+    // Bounce: choques entre glifos (rejilla uniforme + fase estrecha sin locks)
+    bool collisions = false;
+
+    // Semilla de toda la aleatoriedad de la escena (--seed): misma semilla =>
+    // mismo estado bit a bit con cualquier numero de hilos (mismo kernel)
+    std::uint64_t seed = 0;
+
+    // Update y render en hilos distintos (--pipeline): render lee la vista
+    // publicada por publishFrame() mientras update escribe la siguiente
+    bool pipelined = false;
+
+    // Paso fijo (--sim-hz): update guarda la posicion previa de cada elemento
+    // y render(window, alpha) dibuja la mezcla previa + alpha * (actual - previa)
+    bool interpolate = false;
+
+    // update como grafo de tareas (--taskgraph) en un pool con robo de trabajo:
+    // subsistemas independientes a la vez y bucles grandes en subtareas
+    bool taskGraph = false;
+
+    // Backend de los bucles paralelos (--backend): regiones OpenMP, pool con
+    // robo de trabajo o serial. --taskgraph usa el mismo pool si es Pool.
+    Backend backend = Backend::Omp;
+
+    // CPUs de los hilos (--pin, ver Affinity.h): la ranura t va a
+    // pinCpus[t % size]. Vacio = sin fijar. Se fija antes de la init, asi el
+    // primer toque de cada pagina lo hace el hilo que luego la actualiza.
+    std::vector<int> pinCpus;
+};
+
 class TextRender {
 public:
     TextRender(int N,
@@ -18,47 +74,144 @@ public:
                sf::Vector2u windowSize,
                MotionMode mode = MotionMode::Rain,
                float speed = 160.f,
-               Palette palette = Palette::Mono);
+               Palette palette = Palette::Mono,
+               const RenderConfig& cfg = RenderConfig{});
 
     void update(float dt);
-    void render(sf::RenderWindow& window);
+    // alpha en [0, 1]: fraccion del paso siguiente ya transcurrida (solo con
+    // RenderConfig::interpolate; si no, se dibuja el ultimo paso tal cual)
+    void render(sf::RenderWindow& window, float alpha = 1.f);
     void resize(sf::Vector2u newSize);
 
+    // Pipeline: hace visible para render el ultimo update (frontera de frame).
+    // Llamar sin update ni render en curso; sin pipeline no hace nada.
+    void publishFrame();
+
+    // Hilos que obtuvo cada region en su ultima ejecucion (0 = no ejecutada)
+    int siteThreads(ParSite s) const { return siteThreads_[int(s)]; }
+
+    // Ultima ejecucion de cada sitio segun la politica de grano: elementos,
+    // partes pedidas (1 = en el hilo llamador) y tiempo de pared del despacho.
+    // runs cuenta ejecuciones: si no cambio entre dos frames, no corrio.
+    struct SiteRun {
+        std::size_t trip = 0;
+        int parts = 0;
+        double wallMs = 0.0;
+        std::uint64_t runs = 0;
+    };
+    const SiteRun& siteRun(ParSite s) const { return siteRun_[int(s)]; }
+
+    // Elementos minimos por parte del sitio (coste de fork/join / coste por
+    // elemento): por debajo de dos partes el sitio corre en el hilo llamador
+    std::size_t siteGrain(ParSite s) const;
+
+    // Por parte, en la ultima ejecucion del sitio (valen los primeros
+    // siteRun(s).parts valores; suma de sus despachos si hace varios):
+    // busy = tiempo de CPU del hilo en su parte (ms); wait = espera en la
+    // barrera de join, desde que termina la parte hasta que vuelve el despacho
+    const std::vector<double>& siteBusyMs(ParSite s) const { return siteBusyMs_[int(s)]; }
+    const std::vector<double>& siteWaitMs(ParSite s) const { return siteWaitMs_[int(s)]; }
+
+    // Coste de abrir/cerrar las regiones paralelas del ultimo update (ms): por
+    // region, (entrada del ultimo hilo - fork) + (fin de region - salida del
+    // ultimo hilo de su trabajo)
+    double forkJoinMs() const { return forkJoinMs_; }
+
+    // Kernel de particulas efectivo tras resolver --kernel contra la CPU
+    SimdKernel kernelKind() const { return simd_.kind; }
+
+    // Huella (FNV-1a) del estado de simulacion: para comprobar reproducibilidad
+    std::uint64_t stateHash() const;
+
+    // Grafo del ultimo update con sus tiempos por tarea (nullptr sin --taskgraph)
+    const TaskGraph* taskGraph() const { return cfg_.taskGraph ? &graph_ : nullptr; }
+
+    // Backend de los bucles paralelos y los hilos que reparte
+    const ParallelBackend& backend() const { return *par_; }
+
+    // Fija a RenderConfig::pinCpus los hilos del backend de update vistos
+    // desde el hilo que llama (y los del pool del grafo), empezando en la CPU
+    // first de la lista. Lo hace el ctor; con pipelined el ctor solo fija el
+    // backend del render y el hilo de --pipeline llama a esto una vez al
+    // arrancar, con first = 1 (no comparte CPU con el hilo de render).
+    // Devuelve los hilos fijados.
+    int pinThreads(int first = 0);
+    int pinnedThreads() const { return pinned_; }
+
+    // Calidad en tiempo de ejecucion (controlador de presupuesto de frame).
+    // detail en (0, 1]: fraccion de particulas que se simulan y dibujan, o de
+    // columnas de lluvia que se dibujan (repartidas por toda la pantalla); las
+    // inactivas quedan congeladas. threadCap: tope de partes por despacho.
+    // Llamar entre frames (sin update ni render en curso).
+    void setDetail(float detail);
+    float detail() const { return detail_; }
+    void setThreadCap(int threads) {
+        par_->setPartsCap(threads);
+        if (renderPar_) renderPar_->setPartsCap(threads);
+    }
+
+    // Tiempo de carga del OBJ dentro del constructor (Nebula; 0 en otros modos)
+    double objLoadMs() const { return objLoadMs_; }
+
+    // Una fase de update sola (matrix_microbench), con su propio despacho en
+    // el backend: Rain/Dashes son updateRain/updateDashes; Bounce/Spiral/Nebula
+    // recorren las particulas activas con el kernel escalar, sin choques ni
+    // modelo. Una fase de otro modo que el de la escena no hace nada.
+    enum class Phase { Rain, Dashes, Bounce, Spiral, Nebula };
+    void updatePhase(Phase phase, float dt);
+
 private:
     // --------- Partículas (Bounce/Spiral/Nebula) ---------
-    struct Particle {
-        sf::Text text;
-        sf::Vector2f pos;
-        sf::Vector2f vel;
-        float baseSize;
-
-        // Spiral
-        float angle, angVel, baseRadius, radiusAmp;
-        float z, zVel, phase;
-
-        // Nebula
-        float spinDeg;
-        float spinVelDeg;
-        float scale;
-        float scaleVel;
-        float alpha;
-        float alphaVel;
-        float noiseSeed;
-    };
-    std::vector<Particle> ps;
+    ParticleStore ps_;              // estado de simulacion (SoA, lo recorre update)
+    ParticleView  pv_;              // salida de update para el render
+    std::size_t   activeN_ = 0;     // particulas activas: [0, activeN_) (setDetail)
+    ParticleView  pvFront_;         // pipeline: vista publicada (intercambio O(1) con pv_)
+    bool backFresh_ = false;        // pv_ tiene un paso sin publicar
+    // Ultimo paso simulado: pv_, o pvFront_ si aun no hubo update tras publicar
+    const ParticleView& latestView() const {
+        return (cfg_.pipelined && !backFresh_) ? pvFront_ : pv_;
+    }
+    void savePrevPositions(std::size_t b, std::size_t e);
+    SimdKernelSet simd_;            // kernels vectorizados (nullptr = escalar)
+
+    // Choques (Bounce): rejilla y buffers de salida de la fase estrecha
+    SpatialGrid grid_;
+    AlignedVec<float> nPosX_, nPosY_, nVelX_, nVelY_;
+    float collideR_ = 0.f;          // radio de choque (px)
+    std::vector<sf::Text> psText_;  // objetos de dibujo: solo los toca render
 
     // --------- Lluvia Matrix ---------
+    // Solo la cabeza avanza en update (O(columnas)); la posicion, el caracter y
+    // el color de cada glifo de la estela se derivan al dibujar (rainGlyph).
     struct Drop {
-        std::vector<sf::Text> glyphs;
         float x;
-        float headY;
         float spacing;
     };
     std::vector<Drop> drops;
+    // Estado que cambia por frame, aparte para copiarlo al publicar
+    std::vector<float> rainHeadY_;
+    std::vector<float> rainPrevHeadY_; // cabeza antes del ultimo paso (interpolacion)
+    std::vector<int>   rainFlick_;     // ultimo frame en que parpadeo la columna (-1 = nunca)
+
+    // CSR: caracteres base de la gota k = rainCodes_[rainStart_[k] .. rainStart_[k+1])
+    // (el primero es la cabeza). Los bucles por glifo recorren el rango plano.
+    std::vector<char> rainCodes_;
+    std::vector<std::size_t> rainStart_;
+
+    // Columnas que se dibujan con detail < 1 y su CSR de glifos (compacto:
+    // el llenado y el draw solo recorren estas)
+    std::vector<int> rainActive_;
+    std::vector<std::size_t> rainActiveStart_;
+    void selectRainColumns();
+
+    struct RainGlyph {
+        float y;
+        char ch;
+        sf::Color color;
+    };
 
     // --------- Líneas punteadas ---------
     struct DashLine {
-        std::vector<sf::Text> dots;
         float xLeft;
         float y;
         float vx;
@@ -67,9 +220,17 @@ private:
     };
     std::vector<DashLine> dashes;
 
+    // CSR: puntos de la linea li = dashDots_[dashStart_[li] .. dashStart_[li+1])
+    // update solo escribe dashDotX_; los sf::Text los posiciona render
+    std::vector<sf::Text> dashDots_;
+    std::vector<float> dashDotX_;
+    std::vector<float> dashPrevDotX_;
+    std::vector<std::size_t> dashStart_;
+
     // --------- Modelo OBJ (Nebula) ---------
     std::unique_ptr<ObjModel> model_;
     bool   modelEnabled_ = false;
+    double objLoadMs_ = 0.0;
 
     struct ModelCtrl {
         enum class Mode { RotateY, Drift } mode = Mode::RotateY;
@@ -79,8 +240,39 @@ private:
         sf::Vector2f driftVel{0.f, 0.f};  // px/s
         float timer = 0.f;                 // cambia de estado cuando llega a 0
         bool  returning = false;           // en retorno al centro
+        float prevYawDeg = 0.f;            // pose antes del ultimo paso (interpolacion)
+        sf::Vector2f prevOffset{0.f, 0.f};
     } modelCtrl_;
 
+    // --------- Vista de render ---------
+    // Lo que render lee de un frame. Sin pipeline apunta al estado vivo; con
+    // pipeline, a pvFront_ y a la copia de la lluvia/modelo (O(columnas)).
+    struct Published {
+        std::vector<float> headY, prevHeadY;
+        std::vector<int>   flick;
+        std::vector<float> dotX, prevDotX;
+        float time = 0.f;
+        float yawDeg = 0.f, prevYawDeg = 0.f;
+        sf::Vector2f offset{0.f, 0.f}, prevOffset{0.f, 0.f};
+    } published_;
+
+    struct FrameView {
+        const ParticleView* pv;
+        const float* headY;
+        const int*   flick;
+        const float* dotX;
+        float time;
+        float yawDeg;
+        sf::Vector2f offset;
+        float alpha;                // < 1: las particulas mezclan prevX/prevY con x/y
+    };
+    FrameView frameView() const;
+    void publishScene();            // copia lluvia/lineas/modelo a published_
+
+    // Interpolacion (render): cabezas y puntos mezclados, O(columnas)
+    std::vector<float> lerpHeadY_, lerpDotX_;
+    void interpolateScene(FrameView& v, float alpha);
+
     // --------- Estado general ---------
     sf::Vector2u size_;
     MotionMode mode_;
@@ -89,31 +281,107 @@ private:
     float time_ = 0.f;
     std::string alphabet_ = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
     Palette palette_;
+    RenderConfig cfg_;
+    float detail_ = 1.f;
+    std::array<int, int(ParSite::Count)> siteThreads_{};
+    std::array<SiteRun, int(ParSite::Count)> siteRun_{};
+    std::array<double, int(ParSite::Count)> siteItemNs_{};  // coste por elemento (ns)
+    // Partes para n elementos del sitio (anota trip/partes) y cierre con el
+    // equipo real y el tiempo de pared
+    int beginSite(ParSite s, std::size_t n);
+    void endSite(ParSite s, int team, double wallMs);
+    std::array<std::vector<double>, int(ParSite::Count)> siteBusyMs_;
+    std::array<std::vector<double>, int(ParSite::Count)> siteWaitMs_;
+    std::array<std::vector<double>, int(ParSite::Count)> siteLeave_;  // fin de cada parte (pared)
+    // Despacho de parts partes medido por parte como el sitio s (ver siteBusyMs)
+    int runSite(ParSite s, int parts, const ParallelBackend::PartFn& f);
+    class SiteBackend;  // ParallelBackend que despacha por runSite (SpatialGrid)
+
+    // Pool de hilos (--backend pool y/o --taskgraph) y backend de los bucles;
+    // pool_ se declara antes: el backend lo usa hasta destruirse
+    std::unique_ptr<WorkPool> pool_;
+    std::unique_ptr<ParallelBackend> par_;
+    // Con pipelined, los del render (render() corre a la vez que update()
+    // en otro hilo); sin pipelined quedan vacios y el render usa par_
+    std::unique_ptr<WorkPool> renderPool_;
+    std::unique_ptr<ParallelBackend> renderPar_;
+    ParallelBackend& renderBackend() { return renderPar_ ? *renderPar_ : *par_; }
+    ParallelBackend& siteBackend(ParSite s);  // RainFill es del render
+
+    // Despacho medido de n elementos: body(part, parts) en el backend (o en
+    // el llamador si n no llega al grano del sitio); anota el equipo en site
+    // y suma su fork/join
+    std::vector<double> fjEnter_;
+    double forkJoinMs_ = 0.0;
+    template <class Body> void parallelRegion(ParSite site, std::size_t n, Body&& body);
+
+    // Reparto de los bucles de particulas: el de update (partes de
+    // ParSite::Particles, por bloques SIMD enteros si el modo usa kernel
+    // vectorial). La init y la copia de vistas lo repiten para que cada pagina
+    // la toque primero el hilo que la actualiza (first touch, NUMA).
+    void particleRange(std::size_t n, int p, int parts, std::size_t& b, std::size_t& e) const;
+    template <class F> void forParticles(std::size_t n, F&& f);
+    int pinned_ = 0;
+
+    // --taskgraph: el grafo se arma en init/resize; los cuerpos leen graphDt_
+    TaskGraph graph_;
+    float graphDt_ = 0.f;
+    void buildGraph();
+
+    // Caja local (como sf::Text::getLocalBounds) de cada ASCII a charSize_
+    std::array<sf::FloatRect, 128> glyphBox_{};
+
+    // --------- Render por lotes (Rain) ---------
+    const sf::Font* font_ = nullptr;
+    std::array<sf::Glyph, 128> glyphs_{};      // glifos a charSize_ (textura comun)
+    sf::VertexArray rainVA_{sf::Triangles};    // 6 vertices por glifo y luego por punto (orden CSR)
+    std::vector<sf::Text> rainText_;           // --render text: un sf::Text por glifo (orden CSR)
 
     // Helpers color Matrix
     sf::Color neonGreen(unsigned char a = 255) const { return sf::Color(0, 255, 70, a); }
     sf::Color headColor() const { return sf::Color(230, 255, 230); }
 
-    // Colores pseudoaleatorios
-    sf::Color generatePseudoRandomColor(int seed);
+    // Colores pseudoaleatorios (flujo por indice de particula)
+    sf::Color generatePseudoRandomColor(int index);
+
+    // Cambios de estado del modelo: un flujo nuevo por evento
+    std::uint64_t modelEvents_ = 0;
+    CounterRng modelRng();
+
+    // Metricas de glifo (sin tocar la textura de la fuente en update)
+    void initGlyphMetrics(const sf::Font& font);
+    sf::FloatRect glyphBox(char ch, float size) const;
 
     // Inicializaciones
     void initParticles(int N, const sf::Font& font);         // Bounce/Spiral base
     void initNebula(int N, const sf::Font& font);
     void initRain(int approxTotalGlyphs, const sf::Font& font);
     void initDashes(const sf::Font& font, int count);
+    void layoutRainBatch();
+    RainGlyph rainGlyph(const FrameView& v, int k, int i) const;
+    void renderRainBatched(sf::RenderWindow& window, const FrameView& v);
+    void syncParticleTexts(const FrameView& v);
 
     // Actualizaciones
-    void updateBounce(Particle& p, float dt);
-    void updateSpiral(Particle& p, float dt);
-    void updateNebula(Particle& p, float dt);
+    void updateBounce(std::size_t i, float dt);
+    void collideBounce();
+    void updateSpiral(std::size_t i, float dt);
+    void updateNebula(std::size_t i, float dt);
     void updateRain(float dt);
     void updateDashes(float dt);
+    // Parte part de parts de cada fase (llamar desde parallelRegion)
+    void rainColumns(int part, int parts, float dt);
+    void dashDotsPart(int part, int parts);
+    void moveDashLines(float dt);
+    // Cuerpos por rango (los comparten los despachos del backend y el grafo)
+    void advanceRainColumns(std::size_t b, std::size_t e, float dt);
+    void moveDashLine(int li, float dt);
+    void placeDashDots(std::size_t b, std::size_t e);
 
     // Control del modelo (Nebula)
     void updateModel(float dt);
 
     // Utilidad Nebula
-    sf::Vector2f nebulaFlowField(const sf::Vector2f& p, float seed, float t) const;
+    sf::Vector2f nebulaFlowField(float seed, float t) const;
     sf::Color nebulaColor(float t01, float alpha) const;
 };
@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Pool de hilos con robo de trabajo. Cada hilo tiene su cola: el dueno saca
+// por atras (LIFO, datos calientes) y los ladrones por delante (FIFO, trabajo
+// mas antiguo y grande). El hilo que llama a help() ocupa la ranura 0 y
+// trabaja junto a los size()-1 hilos propios del pool.
+class WorkPool {
+public:
+    // Trabajo sin reservas de memoria: funcion + contexto + argumento
+    struct Job {
+        void (*fn)(void* ctx, std::size_t arg, int worker);
+        void* ctx;
+        std::size_t arg;
+    };
+
+    explicit WorkPool(int threads);
+    ~WorkPool();
+    WorkPool(const WorkPool&) = delete;
+    WorkPool& operator=(const WorkPool&) = delete;
+
+    int size() const { return int(queues_.size()); }
+
+    // Encola en la cola de worker (el hilo actual, o 0 desde fuera del pool)
+    void push(const Job& job, int worker);
+
+    // El hilo llamador ejecuta y roba trabajos hasta que remaining llega a 0
+    void help(const std::atomic<int>& remaining);
+
+    // Ranura del hilo actual (0 = hilo llamador o ajeno al pool)
+    static int currentWorker();
+
+    // --pin: la ranura w va a cpus[w % cpus.size()]; la 0 es el hilo que
+    // llama. Devuelve cuantas ranuras quedaron fijadas.
+    int pin(const std::vector<int>& cpus);
+
+private:
+    struct Queue {
+        std::mutex m;
+        std::deque<Job> jobs;
+    };
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::atomic<int> queued_{0};   // trabajos en colas (despierta a los dormidos)
+    std::mutex sleepM_;
+    std::condition_variable sleepCv_;
+    bool stop_ = false;
+
+    bool popLocal(int w, Job& out);
+    bool steal(int w, Job& out);
+    bool tryRun(int w);
+    void workerLoop(int w);
+};
@@ -2,336 +2,720 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <math.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+  #include <fcntl.h>
+  #include <sys/mman.h>
+  #include <sys/stat.h>
+  #include <unistd.h>
+#endif
 
-#define MAX_LINE 4096
-#define MAX_STR   64
+// Analizador de CSVs de benchmark (--bench). Acepta varios ficheros y
+// directorios (sus *.csv con cabecera "exec,"); cada hilo mapea (mmap) y
+// parsea ficheros enteros en su propia tabla hash de grupos y al final se
+// funden. Las columnas se buscan por nombre en la cabecera, asi se leen CSVs
+// de cualquier version (las columnas nuevas van siempre al final).
+//
+// Uso: analyze_bench [-o DIR] [-j HILOS] [--skip K] CSV|DIR...
+//   -o DIR    directorio de salida (defecto: el del primer argumento)
+//   -j HILOS  hilos de parseo (defecto: nucleos logicos)
+//   --skip K  descarta los frames < K de cada ejecucion (calentamiento)
+// Salida: bench_summary2.csv, bench_scaling.csv y Anexo3_Bitacora2.md
+
+#define MAX_STR    64
+#define MAX_FIELDS 64
+
+// -------------------- columnas --------------------
+enum {
+    C_EXEC, C_MODE, C_TREQ, C_TEFF, C_W, C_H, C_N, C_SPEED, C_FRAME,
+    C_UPDATE, C_RENDER, C_TOTAL, C_FPS, C_COUNT
+};
+static const char* const kColNames[C_COUNT] = {
+    "exec", "mode", "threads_req", "threads_eff", "width", "height", "N", "speed", "frame",
+    "update_ms", "render_ms", "total_ms", "fps"
+};
 
 typedef struct {
-    char exec[MAX_STR];      // "seq" | "omp"
-    char mode[MAX_STR];      // "rain" | "bounce" | "spiral" | "nebula"
-    int  threads_req;        // solicitado por CLI
-    int  threads_eff;        // efectivo (omp_get_max_threads)
-    int  width, height, N, frame;
-    double speed, dt_s, update_ms, render_ms, total_ms, fps;
-} Row;
+    int idx[C_COUNT];  // -1 = no esta (solo threads_eff es opcional)
+    int ncols;
+} ColMap;
 
+// -------------------- grupos --------------------
 typedef struct {
-    char exec[MAX_STR];
-    char mode[MAX_STR];
-    int  width, height, N;
+    double* v;
+    size_t  n, cap;
+} DVec;
+
+static int dv_push(DVec* d, double x) {
+    if (d->n == d->cap) {
+        size_t ncap = d->cap ? d->cap * 2 : 256;
+        double* nv = (double*)realloc(d->v, ncap * sizeof(double));
+        if (!nv) return 0;
+        d->v = nv; d->cap = ncap;
+    }
+    d->v[d->n++] = x;
+    return 1;
+}
+
+static int dv_append(DVec* d, const DVec* s) {
+    for (size_t i = 0; i < s->n; ++i) if (!dv_push(d, s->v[i])) return 0;
+    return 1;
+}
+
+static void dv_free(DVec* d) { free(d->v); d->v = NULL; d->n = d->cap = 0; }
+
+typedef struct {
+    char   exec[MAX_STR];      // "seq" | "omp" | "pool" | "graph"
+    char   mode[MAX_STR];      // "rain" | "bounce" | "spiral" | "nebula"
+    int    width, height, N;
     double speed;
-    int  threads_req;
+    int    threads_req;        // solicitado por CLI (0 = defecto del runtime)
+} Key;
+
+typedef struct {
+    Key      key;
+    uint64_t hash;
+    int      used;
 
-    // acumuladores
     double sum_update, sum_render, sum_total, sum_fps;
     double sum_threads_eff;
     int    cnt_threads_eff;
     int    frames;
+    DVec   update, total;      // muestras por frame (percentiles)
 } Group;
 
-static char* trim(char* s) {
-    if (!s) return s;
-    char* p = s; while (*p && isspace((unsigned char)*p)) ++p;
-    if (p != s) memmove(s, p, strlen(p) + 1);
-    size_t n = strlen(s);
-    while (n && isspace((unsigned char)s[n-1])) s[--n] = '\0';
-    return s;
-}
-
-static int split_csv(char* line, char* out[], int max_tokens) {
-    // CSV simple sin comillas: separa por coma
-    int count = 0;
-    char* p = line;
-    while (count < max_tokens) {
-        out[count++] = p;
-        char* c = strchr(p, ',');
-        if (!c) break;
-        *c = '\0';
-        p = c + 1;
+// Tabla hash de direccionamiento abierto (sondeo lineal, cap potencia de 2)
+typedef struct {
+    Group* slots;
+    size_t cap, size;
+} GroupMap;
+
+static uint64_t fnv1a(uint64_t h, const void* p, size_t n) {
+    const unsigned char* b = (const unsigned char*)p;
+    for (size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 1099511628211ULL; }
+    return h;
+}
+
+static uint64_t key_hash(const Key* k) {
+    uint64_t h = 14695981039346656037ULL;
+    h = fnv1a(h, k->exec, strlen(k->exec));
+    h = fnv1a(h, k->mode, strlen(k->mode));
+    h = fnv1a(h, &k->width, sizeof k->width);
+    h = fnv1a(h, &k->height, sizeof k->height);
+    h = fnv1a(h, &k->N, sizeof k->N);
+    h = fnv1a(h, &k->speed, sizeof k->speed);
+    h = fnv1a(h, &k->threads_req, sizeof k->threads_req);
+    return h;
+}
+
+static int same_key(const Key* a, const Key* b) {
+    return strcmp(a->exec, b->exec) == 0 &&
+           strcmp(a->mode, b->mode) == 0 &&
+           a->width  == b->width &&
+           a->height == b->height &&
+           a->N      == b->N &&
+           a->speed  == b->speed &&
+           a->threads_req == b->threads_req;
+}
+
+static int gm_init(GroupMap* m, size_t cap) {
+    m->slots = (Group*)calloc(cap, sizeof(Group));
+    m->cap = m->slots ? cap : 0;
+    m->size = 0;
+    return m->slots != NULL;
+}
+
+static void gm_free(GroupMap* m) {
+    for (size_t i = 0; i < m->cap; ++i)
+        if (m->slots[i].used) { dv_free(&m->slots[i].update); dv_free(&m->slots[i].total); }
+    free(m->slots);
+    m->slots = NULL; m->cap = m->size = 0;
+}
+
+static Group* gm_slot(GroupMap* m, const Key* k, uint64_t h) {
+    size_t i = (size_t)h & (m->cap - 1);
+    while (m->slots[i].used && !(m->slots[i].hash == h && same_key(&m->slots[i].key, k)))
+        i = (i + 1) & (m->cap - 1);
+    return &m->slots[i];
+}
+
+static int gm_grow(GroupMap* m) {
+    GroupMap bigger;
+    if (!gm_init(&bigger, m->cap * 2)) return 0;
+    for (size_t i = 0; i < m->cap; ++i) {
+        if (!m->slots[i].used) continue;
+        *gm_slot(&bigger, &m->slots[i].key, m->slots[i].hash) = m->slots[i];  // mueve los DVec
+        bigger.size++;
     }
-    return count;
-}
-
-static int parse_row_from_tokens(Row* r, char* toks[], int n) {
-    // Espera 14 columnas:
-    // 0 exec,1 mode,2 threads_req,3 threads_eff,4 width,5 height,6 N,7 speed,
-    // 8 frame,9 dt_s,10 update_ms,11 render_ms,12 total_ms,13 fps
-    if (n < 14) return 0;
-    strncpy(r->exec, trim(toks[0]), MAX_STR-1);
-    strncpy(r->mode, trim(toks[1]), MAX_STR-1);
-    r->threads_req = atoi(trim(toks[2]));
-    r->threads_eff = atoi(trim(toks[3]));
-    r->width  = atoi(trim(toks[4]));
-    r->height = atoi(trim(toks[5]));
-    r->N      = atoi(trim(toks[6]));
-    r->speed  = atof(trim(toks[7]));
-    r->frame  = atoi(trim(toks[8]));
-    r->dt_s   = atof(trim(toks[9]));
-    r->update_ms = atof(trim(toks[10]));
-    r->render_ms = atof(trim(toks[11]));
-    r->total_ms  = atof(trim(toks[12]));
-    r->fps       = atof(trim(toks[13]));
+    free(m->slots);
+    *m = bigger;
     return 1;
 }
 
-static int same_key(const Group* g, const Row* r) {
-    return strcmp(g->exec, r->exec) == 0 &&
-           strcmp(g->mode, r->mode) == 0 &&
-           g->width  == r->width &&
-           g->height == r->height &&
-           g->N      == r->N &&
-           g->threads_req == r->threads_req &&
-           g->speed == r->speed; // asumimos entrada consistente
+static Group* gm_get(GroupMap* m, const Key* k) {
+    if ((m->size + 1) * 10 > m->cap * 7 && !gm_grow(m)) return NULL;
+    const uint64_t h = key_hash(k);
+    Group* g = gm_slot(m, k, h);
+    if (!g->used) {
+        memset(g, 0, sizeof(*g));
+        g->key = *k; g->hash = h; g->used = 1;
+        m->size++;
+    }
+    return g;
 }
 
-static void add_row_to_group(Group* g, const Row* r) {
-    g->sum_update += r->update_ms;
-    g->sum_render += r->render_ms;
-    g->sum_total  += r->total_ms;
-    g->sum_fps    += r->fps;
-    if (r->threads_eff > 0) { g->sum_threads_eff += r->threads_eff; g->cnt_threads_eff++; }
-    g->frames++;
+// Funde src en dst (src queda vacia)
+static int gm_merge(GroupMap* dst, GroupMap* src) {
+    for (size_t i = 0; i < src->cap; ++i) {
+        Group* s = &src->slots[i];
+        if (!s->used) continue;
+        Group* d = gm_get(dst, &s->key);
+        if (!d) return 0;
+        d->sum_update += s->sum_update;
+        d->sum_render += s->sum_render;
+        d->sum_total  += s->sum_total;
+        d->sum_fps    += s->sum_fps;
+        d->sum_threads_eff += s->sum_threads_eff;
+        d->cnt_threads_eff += s->cnt_threads_eff;
+        d->frames     += s->frames;
+        if (!dv_append(&d->update, &s->update) || !dv_append(&d->total, &s->total)) return 0;
+    }
+    gm_free(src);
+    return 1;
 }
 
-static void init_group_from_row(Group* g, const Row* r) {
-    memset(g, 0, sizeof(*g));
-    strncpy(g->exec, r->exec, MAX_STR-1);
-    strncpy(g->mode, r->mode, MAX_STR-1);
-    g->width  = r->width;
-    g->height = r->height;
-    g->N      = r->N;
-    g->speed  = r->speed;
-    g->threads_req = r->threads_req;
-    add_row_to_group(g, r);
+// -------------------- E/S: fichero completo en memoria --------------------
+typedef struct {
+    const char* data;
+    size_t size;
+    void*  owned;   // mmap (POSIX) o malloc (_WIN32)
+} FileBuf;
+
+static int open_file(const char* path, FileBuf* fb) {
+    memset(fb, 0, sizeof(*fb));
+#ifndef _WIN32
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return 0;
+    struct stat st;
+    if (fstat(fd, &st) != 0) { close(fd); return 0; }
+    fb->size = (size_t)st.st_size;
+    if (fb->size > 0) {
+        void* p = mmap(NULL, fb->size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED) { close(fd); return 0; }
+        madvise(p, fb->size, MADV_SEQUENTIAL);
+        fb->owned = p;
+        fb->data = (const char*)p;
+    }
+    close(fd);
+    return 1;
+#else
+    FILE* f = fopen(path, "rb");
+    if (!f) return 0;
+    fseek(f, 0, SEEK_END);
+    long n = ftell(f);
+    fseek(f, 0, SEEK_SET);
+    char* p = (char*)malloc(n > 0 ? (size_t)n : 1);
+    if (!p) { fclose(f); return 0; }
+    fb->size = fread(p, 1, n > 0 ? (size_t)n : 0, f);
+    fclose(f);
+    fb->owned = p;
+    fb->data = p;
+    return 1;
+#endif
 }
 
-typedef struct {
-    Group* data;
-    int    size;
-    int    cap;
-} GroupVec;
+static void close_file(FileBuf* fb) {
+#ifndef _WIN32
+    if (fb->owned) munmap(fb->owned, fb->size);
+#else
+    free(fb->owned);
+#endif
+    memset(fb, 0, sizeof(*fb));
+}
 
-static void gv_init(GroupVec* v) { v->data=NULL; v->size=0; v->cap=0; }
-static void gv_free(GroupVec* v) { free(v->data); v->data=NULL; v->size=v->cap=0; }
+// -------------------- parsing --------------------
+typedef struct { const char* b; const char* e; } Field;
 
-static Group* gv_find(GroupVec* v, const Row* r) {
-    for (int i=0;i<v->size;i++) if (same_key(&v->data[i], r)) return &v->data[i];
-    return NULL;
+static void trim_field(Field* f) {
+    while (f->b < f->e && isspace((unsigned char)*f->b)) ++f->b;
+    while (f->e > f->b && isspace((unsigned char)f->e[-1])) --f->e;
 }
 
-static Group* gv_add(GroupVec* v, const Row* r) {
-    if (v->size == v->cap) {
-        int ncap = v->cap ? v->cap*2 : 64;
-        Group* nd = (Group*)realloc(v->data, ncap * sizeof(Group));
-        if (!nd) return NULL;
-        v->data = nd; v->cap = ncap;
+// Divide [b, e) por comas (CSV simple sin comillas)
+static int split_fields(const char* b, const char* e, Field out[], int max_fields) {
+    int n = 0;
+    while (n < max_fields) {
+        const char* c = (const char*)memchr(b, ',', (size_t)(e - b));
+        out[n].b = b; out[n].e = c ? c : e;
+        trim_field(&out[n]);
+        ++n;
+        if (!c) break;
+        b = c + 1;
     }
-    init_group_from_row(&v->data[v->size], r);
-    return &v->data[v->size++];
+    return n;
 }
 
-static int load_rows(const char* path, Row** out_rows, int* out_nrows) {
-    FILE* f = fopen(path, "r");
-    if (!f) { fprintf(stderr, "No pude abrir %s\n", path); return 0; }
+static void field_str(const Field* f, char* out, size_t outsz) {
+    size_t n = (size_t)(f->e - f->b);
+    if (n >= outsz) n = outsz - 1;
+    memcpy(out, f->b, n);
+    out[n] = '\0';
+}
 
-    char line[MAX_LINE];
-    // header
-    if (!fgets(line, sizeof(line), f)) { fclose(f); return 0; }
+// El mapa no termina en '\0': se copia el campo antes de strtod
+static double field_double(const Field* f) {
+    char buf[MAX_STR];
+    field_str(f, buf, sizeof buf);
+    return atof(buf);
+}
 
-    // validar columnas mínimas
-    // Permitimos encabezado con "exec,"; si no, aborta.
-    if (strncmp(line, "exec,", 5) != 0) {
-        fprintf(stderr, "Encabezado inesperado. Esperaba columnas que inicien con 'exec,'.\n");
-        fclose(f);
-        return 0;
+static int field_int(const Field* f) {
+    char buf[MAX_STR];
+    field_str(f, buf, sizeof buf);
+    return atoi(buf);
+}
+
+static int field_is(const Field* f, const char* name) {
+    size_t n = strlen(name);
+    return (size_t)(f->e - f->b) == n && memcmp(f->b, name, n) == 0;
+}
+
+static int parse_header(const char* b, const char* e, ColMap* cm) {
+    Field f[MAX_FIELDS];
+    int n = split_fields(b, e, f, MAX_FIELDS);
+    if (n < 1 || !field_is(&f[0], "exec")) return 0;
+    for (int c = 0; c < C_COUNT; ++c) {
+        cm->idx[c] = -1;
+        for (int i = 0; i < n; ++i) if (field_is(&f[i], kColNames[c])) { cm->idx[c] = i; break; }
+        if (cm->idx[c] < 0 && c != C_TEFF) return 0;
     }
+    cm->ncols = 0;
+    for (int c = 0; c < C_COUNT; ++c) cm->ncols = std::max(cm->ncols, cm->idx[c] + 1);
+    return 1;
+}
 
-    int cap = 1024, n = 0;
-    Row* rows = (Row*)malloc(cap * sizeof(Row));
-    if (!rows) { fclose(f); return 0; }
-
-    while (fgets(line, sizeof(line), f)) {
-        char* p = strchr(line, '\n'); if (p) *p = '\0';
-        if (!*line) continue;
-        char* toks[32]; int nt = split_csv(line, toks, 32);
-        Row r;
-        if (!parse_row_from_tokens(&r, toks, nt)) continue;
-
-        if (n == cap) {
-            cap *= 2;
-            Row* nr = (Row*)realloc(rows, cap * sizeof(Row));
-            if (!nr) { free(rows); fclose(f); return 0; }
-            rows = nr;
-        }
-        rows[n++] = r;
+typedef struct {
+    size_t rows, skipped, bad;
+} ParseStats;
+
+static int add_line(GroupMap* m, const ColMap* cm, const Field* f, int n, int skip, ParseStats* ps) {
+    if (n < cm->ncols) { ps->bad++; return 1; }
+    if (field_int(&f[cm->idx[C_FRAME]]) < skip) { ps->skipped++; return 1; }
+
+    Key k;
+    memset(&k, 0, sizeof k);
+    field_str(&f[cm->idx[C_EXEC]], k.exec, MAX_STR);
+    field_str(&f[cm->idx[C_MODE]], k.mode, MAX_STR);
+    k.threads_req = field_int(&f[cm->idx[C_TREQ]]);
+    k.width  = field_int(&f[cm->idx[C_W]]);
+    k.height = field_int(&f[cm->idx[C_H]]);
+    k.N      = field_int(&f[cm->idx[C_N]]);
+    k.speed  = field_double(&f[cm->idx[C_SPEED]]);
+
+    Group* g = gm_get(m, &k);
+    if (!g) return 0;
+    const double up = field_double(&f[cm->idx[C_UPDATE]]);
+    const double tp = field_double(&f[cm->idx[C_TOTAL]]);
+    g->sum_update += up;
+    g->sum_render += field_double(&f[cm->idx[C_RENDER]]);
+    g->sum_total  += tp;
+    g->sum_fps    += field_double(&f[cm->idx[C_FPS]]);
+    if (cm->idx[C_TEFF] >= 0) {
+        int te = field_int(&f[cm->idx[C_TEFF]]);
+        if (te > 0) { g->sum_threads_eff += te; g->cnt_threads_eff++; }
     }
-    fclose(f);
-    *out_rows = rows;
-    *out_nrows = n;
+    g->frames++;
+    if (!dv_push(&g->update, up) || !dv_push(&g->total, tp)) return 0;
+    ps->rows++;
     return 1;
 }
 
-static void dirname_from_path(const char* in, char* out, size_t outsz) {
-    strncpy(out, in, outsz-1); out[outsz-1]='\0';
-    char* slash = strrchr(out, '/');
-#ifdef _WIN32
-    char* bslash = strrchr(out, '\\');
-    if (!slash || (bslash && bslash > slash)) slash = bslash;
-#endif
-    if (slash) *slash = '\0';
-    else { out[0]='.'; out[1]='\0'; }
+// 1 = ok, 0 = fichero ilegible o sin cabecera "exec,", -1 = memoria
+static int parse_file(const char* path, int skip, GroupMap* m, ParseStats* ps) {
+    FileBuf fb;
+    if (!open_file(path, &fb)) return 0;
+    const char* p = fb.data;
+    const char* end = fb.data + fb.size;
+    ColMap cm;
+    int ok = 0, header = 1;
+    while (p < end) {
+        const char* nl = (const char*)memchr(p, '\n', (size_t)(end - p));
+        const char* le = nl ? nl : end;
+        const char* next = nl ? nl + 1 : end;
+        if (le > p && le[-1] == '\r') --le;
+        if (header) {
+            if (!parse_header(p, le, &cm)) break;
+            header = 0; ok = 1;
+        } else if (le > p) {
+            Field f[MAX_FIELDS];
+            int n = split_fields(p, le, f, MAX_FIELDS);
+            if (!add_line(m, &cm, f, n, skip, ps)) { ok = -1; break; }
+        }
+        p = next;
+    }
+    close_file(&fb);
+    return ok;
 }
 
-static int write_summary_csv(const char* dir, const GroupVec* v, const GroupVec* bases) {
+// -------------------- estadisticas --------------------
+// Percentil por rango mas cercano sobre la muestra ordenada
+static double percentile(const DVec* d, double p) {
+    if (!d->n) return 0.0;
+    size_t k = (size_t)ceil(p * (double)d->n);
+    if (k < 1) k = 1;
+    if (k > d->n) k = d->n;
+    return d->v[k - 1];
+}
+
+typedef struct {
+    const Group* g;
+    double update_avg, render_avg, total_avg, fps_avg, threads_eff_avg;
+    double update_p50, total_p50, total_p95, total_p99;
+    double p;          // hilos para eficiencia: 1 en seq; threads_eff medio o, si no hay, threads_req
+    double speedup;    // total_ms medio de la linea base seq / el del grupo (0 = sin base)
+    double efficiency; // speedup / p
+    double karp_flatt; // fraccion serie experimental (NAN si p <= 1)
+} Summary;
+
+static int is_seq(const Group* g) { return strcmp(g->key.exec, "seq") == 0; }
+
+static int same_config(const Key* a, const Key* b) {
+    return strcmp(a->mode, b->mode) == 0 && a->width == b->width && a->height == b->height &&
+           a->N == b->N && a->speed == b->speed;
+}
+
+static double karp_flatt(double speedup, double p) {
+    if (p <= 1.0 || speedup <= 0.0) return NAN;
+    return (1.0 / speedup - 1.0 / p) / (1.0 - 1.0 / p);
+}
+
+static void summarize(Group* g, Summary* s) {
+    memset(s, 0, sizeof(*s));
+    s->g = g;
+    const double fr = g->frames ? (double)g->frames : 1.0;
+    s->update_avg = g->sum_update / fr;
+    s->render_avg = g->sum_render / fr;
+    s->total_avg  = g->sum_total / fr;
+    s->fps_avg    = g->sum_fps / fr;
+    s->threads_eff_avg = g->cnt_threads_eff ? g->sum_threads_eff / g->cnt_threads_eff : 0.0;
+    std::sort(g->update.v, g->update.v + g->update.n);
+    std::sort(g->total.v, g->total.v + g->total.n);
+    s->update_p50 = percentile(&g->update, 0.50);
+    s->total_p50  = percentile(&g->total, 0.50);
+    s->total_p95  = percentile(&g->total, 0.95);
+    s->total_p99  = percentile(&g->total, 0.99);
+    if (is_seq(g)) s->p = 1.0;
+    else s->p = s->threads_eff_avg > 0.0 ? s->threads_eff_avg : (double)std::max(1, g->key.threads_req);
+    s->karp_flatt = NAN;
+}
+
+// Linea base seq por configuracion: frames de todos los grupos seq con la misma
+// (mode, width, height, N, speed), sea cual sea su threads_req
+static double seq_total_avg(const std::vector<Summary>& all, const Key* k) {
+    double sum = 0.0; int frames = 0;
+    for (const Summary& b : all)
+        if (is_seq(b.g) && same_config(&b.g->key, k)) { sum += b.g->sum_total; frames += b.g->frames; }
+    return frames ? sum / frames : 0.0;
+}
+
+static void fill_speedups(std::vector<Summary>& all) {
+    for (Summary& s : all) {
+        const double t1 = seq_total_avg(all, &s.g->key);
+        if (t1 > 0.0 && s.total_avg > 0.0) s.speedup = t1 / s.total_avg;
+        s.efficiency = s.speedup > 0.0 ? s.speedup / s.p : 0.0;
+        s.karp_flatt = karp_flatt(s.speedup, s.p);
+    }
+}
+
+static bool summary_less(const Summary& a, const Summary& b) {
+    const Key& x = a.g->key; const Key& y = b.g->key;
+    int c = strcmp(x.mode, y.mode);
+    if (c) return c < 0;
+    if (x.width != y.width)   return x.width < y.width;
+    if (x.height != y.height) return x.height < y.height;
+    if (x.N != y.N)           return x.N < y.N;
+    if (x.speed != y.speed)   return x.speed < y.speed;
+    if (is_seq(a.g) != is_seq(b.g)) return is_seq(a.g);
+    c = strcmp(x.exec, y.exec);
+    if (c) return c < 0;
+    if (a.p != b.p) return a.p < b.p;
+    return x.threads_req < y.threads_req;
+}
+
+// -------------------- escalado --------------------
+// strong: misma escena, mas hilos; base = seq de la misma configuracion
+// weak:   N crece con los hilos; base = seq con N/p (mismo modo, resolucion y velocidad)
+typedef struct {
+    const char* kind;
+    const Summary* s;
+    int    base_N;
+    double base_ms, time_ms;
+    double speedup, efficiency, karp_flatt;
+} ScaleRow;
+
+static std::vector<ScaleRow> scaling_rows(const std::vector<Summary>& all) {
+    std::vector<ScaleRow> rows;
+    for (const Summary& s : all) {
+        if (is_seq(s.g) || s.speedup <= 0.0) continue;
+        ScaleRow r = { "strong", &s, s.g->key.N, seq_total_avg(all, &s.g->key), s.total_avg,
+                       s.speedup, s.efficiency, s.karp_flatt };
+        rows.push_back(r);
+    }
+    for (const Summary& s : all) {
+        if (is_seq(s.g) || s.p < 1.5) continue;
+        const int p = (int)lround(s.p);
+        for (const Summary& b : all) {
+            const Key& bk = b.g->key; const Key& k = s.g->key;
+            if (!is_seq(b.g) || bk.N >= k.N || strcmp(bk.mode, k.mode) != 0 ||
+                bk.width != k.width || bk.height != k.height || bk.speed != k.speed) continue;
+            if (abs(bk.N * p - k.N) > p) continue;   // N/p con redondeo
+            // Eficiencia debil = T1(N/p) / Tp(N); speedup escalado = p * eficiencia
+            const double eff = s.total_avg > 0.0 ? b.total_avg / s.total_avg : 0.0;
+            ScaleRow r = { "weak", &s, bk.N, b.total_avg, s.total_avg, eff * p, eff, NAN };
+            rows.push_back(r);
+            break;
+        }
+    }
+    return rows;
+}
+
+// -------------------- salida --------------------
+static void fmt_opt(char* out, size_t n, double v, const char* na) {
+    if (isnan(v)) snprintf(out, n, "%s", na);
+    else snprintf(out, n, "%.3f", v);
+}
+
+static int write_summary_csv(const char* dir, const std::vector<Summary>& all) {
     char outpath[1024];
     snprintf(outpath, sizeof(outpath), "%s/bench_summary2.csv", dir);
     FILE* f = fopen(outpath, "w");
     if (!f) { fprintf(stderr, "No pude escribir %s\n", outpath); return 0; }
 
-    fprintf(f, "exec,mode,threads_req,threads_eff_avg,width,height,N,speed,frames,update_ms_avg,render_ms_avg,total_ms_avg,fps_avg,speedup_vs_seq\n");
-    for (int i=0;i<v->size;i++) {
-        const Group* g = &v->data[i];
-        double up = g->frames ? g->sum_update / g->frames : 0.0;
-        double rp = g->frames ? g->sum_render / g->frames : 0.0;
-        double tp = g->frames ? g->sum_total  / g->frames : 0.0;
-        double fp = g->frames ? g->sum_fps    / g->frames : 0.0;
-        double th_eff = g->cnt_threads_eff ? g->sum_threads_eff / g->cnt_threads_eff : 0.0;
-
-        // buscar baseline secuencial (mismo mode,width,height,N,speed)
-        double speedup = 0.0;
-        for (int j=0;j<bases->size;j++) {
-            const Group* b = &bases->data[j];
-            if (strcmp(b->mode, g->mode)==0 &&
-                b->width==g->width && b->height==g->height &&
-                b->N==g->N && b->speed==g->speed) {
-                double t1 = b->frames ? b->sum_total / b->frames : 0.0;
-                if (tp > 0.0 && t1 > 0.0) speedup = t1 / tp;
-                break;
-            }
-        }
+    fprintf(f, "exec,mode,threads_req,threads_eff_avg,width,height,N,speed,frames,update_ms_avg,render_ms_avg,total_ms_avg,fps_avg,speedup_vs_seq,"
+               "update_ms_p50,total_ms_p50,total_ms_p95,total_ms_p99,efficiency,karp_flatt\n");
+    for (const Summary& s : all) {
+        const Group* g = s.g;
+        char kf[32]; fmt_opt(kf, sizeof kf, s.karp_flatt, "");
+        fprintf(f, "%s,%s,%d,%.2f,%d,%d,%d,%.3f,%d,%.3f,%.3f,%.3f,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%s\n",
+            g->key.exec, g->key.mode, g->key.threads_req, s.threads_eff_avg, g->key.width, g->key.height,
+            g->key.N, g->key.speed, g->frames, s.update_avg, s.render_avg, s.total_avg, s.fps_avg, s.speedup,
+            s.update_p50, s.total_p50, s.total_p95, s.total_p99, s.efficiency, kf);
+    }
+    fclose(f);
+    printf("Escrito: %s\n", outpath);
+    return 1;
+}
+
+static int write_scaling_csv(const char* dir, const std::vector<ScaleRow>& rows) {
+    char outpath[1024];
+    snprintf(outpath, sizeof(outpath), "%s/bench_scaling.csv", dir);
+    FILE* f = fopen(outpath, "w");
+    if (!f) { fprintf(stderr, "No pude escribir %s\n", outpath); return 0; }
 
-        fprintf(f, "%s,%s,%d,%.2f,%d,%d,%d,%.3f,%d,%.3f,%.3f,%.3f,%.2f,%.3f\n",
-            g->exec, g->mode, g->threads_req, th_eff, g->width, g->height, g->N, g->speed,
-            g->frames, up, rp, tp, fp, speedup);
+    fprintf(f, "kind,exec,mode,width,height,speed,threads_req,threads,N,base_N,base_total_ms,total_ms,speedup,efficiency,karp_flatt\n");
+    for (const ScaleRow& r : rows) {
+        const Key& k = r.s->g->key;
+        char kf[32]; fmt_opt(kf, sizeof kf, r.karp_flatt, "");
+        fprintf(f, "%s,%s,%s,%d,%d,%.3f,%d,%.2f,%d,%d,%.3f,%.3f,%.3f,%.3f,%s\n",
+            r.kind, k.exec, k.mode, k.width, k.height, k.speed, k.threads_req, r.s->p, k.N, r.base_N,
+            r.base_ms, r.time_ms, r.speedup, r.efficiency, kf);
     }
     fclose(f);
     printf("Escrito: %s\n", outpath);
     return 1;
 }
 
-static int write_anexo_md(const char* dir, const GroupVec* v, const GroupVec* bases) {
+static void write_scaling_md(FILE* f, const std::vector<ScaleRow>& rows, const char* kind) {
+    fprintf(f, "| exec | mode | width | height | hilos | N | N base | total_ms base | total_ms | speedup | eficiencia | Karp–Flatt |\n");
+    fprintf(f, "|:----:|:----:|:-----:|:------:|:-----:|--:|-------:|--------------:|---------:|--------:|-----------:|-----------:|\n");
+    for (const ScaleRow& r : rows) {
+        if (strcmp(r.kind, kind) != 0) continue;
+        const Key& k = r.s->g->key;
+        char kf[32]; fmt_opt(kf, sizeof kf, r.karp_flatt, "-");
+        fprintf(f, "| %s | %s | %d | %d | %.2f | %d | %d | %.3f | %.3f | %.3f | %.3f | %s |\n",
+            k.exec, k.mode, k.width, k.height, r.s->p, k.N, r.base_N, r.base_ms, r.time_ms,
+            r.speedup, r.efficiency, kf);
+    }
+    fprintf(f, "\n");
+}
+
+static int write_anexo_md(const char* dir, const std::vector<Summary>& all, const std::vector<ScaleRow>& rows) {
     char outpath[1024];
     snprintf(outpath, sizeof(outpath), "%s/Anexo3_Bitacora2.md", dir);
     FILE* f = fopen(outpath, "w");
     if (!f) { fprintf(stderr, "No pude escribir %s\n", outpath); return 0; }
 
     fprintf(f, "# Anexo 3 — Bitácora de pruebas\n\n");
-    fprintf(f, "Resumen de ejecuciones (sec./par.) agregadas desde el CSV de benchmark.\n\n");
-    fprintf(f, "| exec | mode | threads_req | threads_eff_avg | width | height | N | speed | frames | update_ms_avg | render_ms_avg | total_ms_avg | fps_avg | speedup_vs_seq |\n");
-    fprintf(f, "|:----:|:----:|:-----------:|:---------------:|:-----:|:------:|:--:|:-----:|:------:|--------------:|--------------:|-------------:|--------:|---------------:|\n");
-
-    for (int i=0;i<v->size;i++) {
-        const Group* g = &v->data[i];
-        double up = g->frames ? g->sum_update / g->frames : 0.0;
-        double rp = g->frames ? g->sum_render / g->frames : 0.0;
-        double tp = g->frames ? g->sum_total  / g->frames : 0.0;
-        double fp = g->frames ? g->sum_fps    / g->frames : 0.0;
-        double th_eff = g->cnt_threads_eff ? g->sum_threads_eff / g->cnt_threads_eff : 0.0;
-
-        double speedup = 0.0;
-        for (int j=0;j<bases->size;j++) {
-            const Group* b = &bases->data[j];
-            if (strcmp(b->mode, g->mode)==0 &&
-                b->width==g->width && b->height==g->height &&
-                b->N==g->N && b->speed==g->speed) {
-                double t1 = b->frames ? b->sum_total / b->frames : 0.0;
-                if (tp > 0.0 && t1 > 0.0) speedup = t1 / tp;
-                break;
-            }
-        }
-
-        fprintf(f, "| %s | %s | %d | %.2f | %d | %d | %d | %.3f | %d | %.3f | %.3f | %.3f | %.2f | %.3f |\n",
-            g->exec, g->mode, g->threads_req, th_eff, g->width, g->height, g->N, g->speed,
-            g->frames, up, rp, tp, fp, speedup);
+    fprintf(f, "Resumen de ejecuciones (sec./par.) agregadas desde los CSV de benchmark.\n\n");
+    fprintf(f, "| exec | mode | threads_req | threads_eff_avg | width | height | N | speed | frames | update_ms_avg | render_ms_avg | total_ms_avg | fps_avg | speedup_vs_seq | total_ms p50 | p95 | p99 | eficiencia | Karp–Flatt |\n");
+    fprintf(f, "|:----:|:----:|:-----------:|:---------------:|:-----:|:------:|:--:|:-----:|:------:|--------------:|--------------:|-------------:|--------:|---------------:|-------------:|----:|----:|-----------:|-----------:|\n");
+    for (const Summary& s : all) {
+        const Group* g = s.g;
+        char kf[32]; fmt_opt(kf, sizeof kf, s.karp_flatt, "-");
+        fprintf(f, "| %s | %s | %d | %.2f | %d | %d | %d | %.3f | %d | %.3f | %.3f | %.3f | %.2f | %.3f | %.3f | %.3f | %.3f | %.3f | %s |\n",
+            g->key.exec, g->key.mode, g->key.threads_req, s.threads_eff_avg, g->key.width, g->key.height,
+            g->key.N, g->key.speed, g->frames, s.update_avg, s.render_avg, s.total_avg, s.fps_avg, s.speedup,
+            s.total_p50, s.total_p95, s.total_p99, s.efficiency, kf);
     }
-    fprintf(f, "\n");
+    fprintf(f, "\n## Escalado fuerte\n\nMisma escena con más hilos; base: `seq` de la misma configuración. "
+               "Eficiencia = speedup / hilos; Karp–Flatt = (1/S − 1/p) / (1 − 1/p) (fracción serie "
+               "experimental: si crece con p, el coste es de sobrecarga y no de la parte serie).\n\n");
+    write_scaling_md(f, rows, "strong");
+    fprintf(f, "## Escalado débil\n\nN crece con los hilos; base: `seq` con N/p. "
+               "Eficiencia = T1(N/p) / Tp(N); speedup escalado = p × eficiencia.\n\n");
+    write_scaling_md(f, rows, "weak");
     fclose(f);
     printf("Escrito: %s\n", outpath);
     return 1;
 }
 
-int main(int argc, char** argv) {
-    if (argc < 2) {
-        fprintf(stderr, "Uso: %s bench/bench_YYYYmmdd_HHMMSS.csv\n", argv[0]);
-        return 1;
+// -------------------- entrada --------------------
+// CSV por frame de --bench: cabecera "exec,..." con columna frame (los
+// resumenes que escribe este programa tienen "frames" y quedan fuera)
+static int looks_like_bench(const std::filesystem::path& p) {
+    if (p.extension() != ".csv") return 0;
+    FILE* f = fopen(p.string().c_str(), "r");
+    if (!f) return 0;
+    char head[4096];
+    const char* line = fgets(head, sizeof head, f);
+    fclose(f);
+    return line && strncmp(head, "exec,", 5) == 0 && strstr(head, ",frame,") != NULL;
+}
+
+// Ficheros y directorios (sus *.csv de benchmark, no recursivo)
+static int collect_inputs(const std::vector<std::string>& args, std::vector<std::string>& files) {
+    namespace fs = std::filesystem;
+    for (const std::string& a : args) {
+        std::error_code ec;
+        if (fs::is_directory(a, ec)) {
+            std::vector<std::string> found;
+            for (const fs::directory_entry& e : fs::directory_iterator(a, ec))
+                if (e.is_regular_file(ec) && looks_like_bench(e.path())) found.push_back(e.path().string());
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        } else if (fs::is_regular_file(a, ec)) {
+            files.push_back(a);
+        } else {
+            fprintf(stderr, "No existe %s\n", a.c_str());
+            return 0;
+        }
     }
+    return 1;
+}
 
-    Row* rows = NULL; int nrows = 0;
-    if (!load_rows(argv[1], &rows, &nrows)) {
+static void dirname_from_path(const char* in, char* out, size_t outsz) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (fs::is_directory(in, ec)) { snprintf(out, outsz, "%s", in); return; }
+    strncpy(out, in, outsz-1); out[outsz-1]='\0';
+    char* slash = strrchr(out, '/');
+#ifdef _WIN32
+    char* bslash = strrchr(out, '\\');
+    if (!slash || (bslash && bslash > slash)) slash = bslash;
+#endif
+    if (slash) *slash = '\0';
+    else { out[0]='.'; out[1]='\0'; }
+}
+
+static void usage(const char* prog) {
+    fprintf(stderr, "Uso: %s [-o DIR] [-j HILOS] [--skip K] bench/bench_YYYYmmdd_HHMMSS.csv|bench/ ...\n", prog);
+}
+
+int main(int argc, char** argv) {
+    const char* outArg = NULL;
+    int jobs = (int)std::thread::hardware_concurrency();
+    int skip = 0;
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) outArg = argv[++i];
+        else if (strcmp(argv[i], "-j") == 0 && i + 1 < argc) jobs = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--skip") == 0 && i + 1 < argc) skip = atoi(argv[++i]);
+        else if (argv[i][0] == '-') { usage(argv[0]); return 1; }
+        else args.push_back(argv[i]);
+    }
+    if (args.empty()) { usage(argv[0]); return 1; }
+
+    std::vector<std::string> files;
+    if (!collect_inputs(args, files)) return 1;
+    if (files.empty()) { fprintf(stderr, "Ningún CSV de benchmark.\n"); return 1; }
+    jobs = std::max(1, std::min(jobs, (int)files.size()));
+
+    // Un fichero por turno y por hilo, cada hilo en su tabla (sin bloqueos)
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<GroupMap> maps((size_t)jobs);
+    std::vector<ParseStats> stats((size_t)jobs);
+    std::vector<int> result(files.size(), 1);
+    std::atomic<size_t> next{0};
+    std::atomic<int> oom{0};
+    auto worker = [&](int w) {
+        if (!gm_init(&maps[(size_t)w], 64)) { oom = 1; return; }
+        memset(&stats[(size_t)w], 0, sizeof(ParseStats));
+        for (size_t i; (i = next.fetch_add(1)) < files.size() && !oom; ) {
+            result[i] = parse_file(files[i].c_str(), skip, &maps[(size_t)w], &stats[(size_t)w]);
+            if (result[i] < 0) oom = 1;
+        }
+    };
+    std::vector<std::thread> pool;
+    for (int w = 1; w < jobs; ++w) pool.emplace_back(worker, w);
+    worker(0);
+    for (std::thread& t : pool) t.join();
+
+    GroupMap groups;
+    int ok = !oom && gm_init(&groups, 256);
+    ParseStats total = { 0, 0, 0 };
+    for (int w = 0; w < jobs; ++w) {
+        if (ok && !gm_merge(&groups, &maps[(size_t)w])) ok = 0;
+        total.rows += stats[(size_t)w].rows;
+        total.skipped += stats[(size_t)w].skipped;
+        total.bad += stats[(size_t)w].bad;
+    }
+    if (!ok) {
+        fprintf(stderr, "Memoria insuficiente.\n");
+        for (GroupMap& m : maps) gm_free(&m);
+        gm_free(&groups);
         return 1;
     }
-    if (nrows == 0) {
+    for (size_t i = 0; i < files.size(); ++i)
+        if (result[i] == 0) fprintf(stderr, "Ignorado %s: ilegible o sin cabecera 'exec,' con las columnas mínimas\n", files[i].c_str());
+    const double parse_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    printf("Leídos %zu ficheros, %zu filas (%zu de calentamiento, %zu incompletas) en %.1f ms con %d hilos; %zu grupos\n",
+           files.size(), total.rows, total.skipped, total.bad, parse_ms, jobs, groups.size);
+    if (total.rows == 0) {
         fprintf(stderr, "CSV sin filas.\n");
-        free(rows);
+        gm_free(&groups);
         return 1;
     }
 
-    GroupVec groups; gv_init(&groups);
-    for (int i=0;i<nrows;i++) {
-        Group* g = gv_find(&groups, &rows[i]);
-        if (!g) g = gv_add(&groups, &rows[i]);
-        if (!g) { fprintf(stderr, "Memoria insuficiente.\n"); free(rows); gv_free(&groups); return 1; }
-        add_row_to_group(g, &rows[i]);
-    }
-
-    // Baselines secuenciales por (mode,width,height,N,speed)
-    GroupVec bases; gv_init(&bases);
-    for (int i=0;i<groups.size;i++) {
-        Group* g = &groups.data[i];
-        if (strcmp(g->exec, "seq")==0) {
-            // clave sólo por configuración sin threads_req
-            // guardamos una copia
-            Group copy = *g;
-            // threads_req no importa para el baseline
-            Group* slot = NULL;
-            // buscar si ya existe exacto (misma conf)
-            for (int j=0;j<bases.size;j++) {
-                Group* b = &bases.data[j];
-                if (strcmp(b->mode, g->mode)==0 &&
-                    b->width==g->width && b->height==g->height &&
-                    b->N==g->N && b->speed==g->speed) {
-                    slot = b; break;
-                }
-            }
-            if (!slot) {
-                if (bases.size == bases.cap) {
-                    int ncap = bases.cap ? bases.cap*2 : 32;
-                    Group* nd = (Group*)realloc(bases.data, ncap*sizeof(Group));
-                    if (!nd) { fprintf(stderr, "Memoria insuficiente.\n"); free(rows); gv_free(&groups); gv_free(&bases); return 1; }
-                    bases.data = nd; bases.cap = ncap;
-                }
-                bases.data[bases.size++] = copy;
-            } else {
-                // acumula si hubiera múltiples grupos seq (distinto threads_req)
-                slot->sum_update += g->sum_update;
-                slot->sum_render += g->sum_render;
-                slot->sum_total  += g->sum_total;
-                slot->sum_fps    += g->sum_fps;
-                slot->sum_threads_eff += g->sum_threads_eff;
-                slot->cnt_threads_eff += g->cnt_threads_eff;
-                slot->frames     += g->frames;
-            }
-        }
+    std::vector<Summary> all;
+    all.reserve(groups.size);
+    for (size_t i = 0; i < groups.cap; ++i) {
+        if (!groups.slots[i].used) continue;
+        Summary s;
+        summarize(&groups.slots[i], &s);
+        all.push_back(s);
     }
+    fill_speedups(all);
+    std::sort(all.begin(), all.end(), summary_less);
+    const std::vector<ScaleRow> rows = scaling_rows(all);
 
     char outdir[1024];
-    dirname_from_path(argv[1], outdir, sizeof(outdir));
+    if (outArg) snprintf(outdir, sizeof(outdir), "%s", outArg);
+    else dirname_from_path(args[0].c_str(), outdir, sizeof(outdir));
 
-    int ok1 = write_summary_csv(outdir, &groups, &bases);
-    int ok2 = write_anexo_md(outdir, &groups, &bases);
+    int ok1 = write_summary_csv(outdir, all);
+    int ok2 = write_scaling_csv(outdir, rows);
+    int ok3 = write_anexo_md(outdir, all, rows);
 
-    free(rows);
-    gv_free(&groups);
-    gv_free(&bases);
-    return (ok1 && ok2) ? 0 : 1;
-}
\ No newline at end of file
+    gm_free(&groups);
+    return (ok1 && ok2 && ok3) ? 0 : 1;
+}
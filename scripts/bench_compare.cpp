@@ -0,0 +1,213 @@
+// Compuerta de regresion de rendimiento entre dos CSVs de --bench.
+//
+// Uso: bench_compare BASE.csv CAND.csv [--metric update_ms|render_ms|total_ms]
+//                    [--threshold PCT] [--alpha A] [--skip K] [--min-frames M]
+//
+// Agrupa cada CSV por (exec, mode, width, height, N, threads_req), la clave
+// de analyze_bench (otra resolucion es otra escena), y, por grupo, compara
+// los tiempos por frame con Mann-Whitney U unilateral (H1: el candidato tarda
+// mas; aproximacion normal con correccion por empates y por continuidad). Un grupo
+// es regresion si p < alpha Y la mediana sube mas de threshold %; si solo se
+// cumple una de las dos, es ruido o un cambio demasiado pequeno para fallar.
+// Devuelve 1 si hay alguna regresion, 2 si la entrada no vale, 0 si no.
+//
+// Los frames de una ejecucion no son independientes (caches, frecuencia de
+// la CPU): el p-valor es orientativo y el umbral de la mediana es el que
+// decide que cambio importa. Usar --skip para quitar el calentamiento.
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+namespace {
+
+struct Options {
+    std::string basePath, candPath;
+    std::string metric = "update_ms";
+    double thresholdPct = 5.0;
+    double alpha = 0.01;
+    int skip = 10;
+    int minFrames = 20;
+};
+
+struct GroupKey {
+    std::string exec, mode;
+    int width = 0, height = 0, N = 0, threads = 0;
+    bool operator<(const GroupKey& o) const {
+        return std::tie(mode, width, height, N, exec, threads)
+             < std::tie(o.mode, o.width, o.height, o.N, o.exec, o.threads);
+    }
+};
+
+using Samples = std::map<GroupKey, std::vector<double>>;
+
+std::vector<std::string> split(const std::string& line) {
+    std::vector<std::string> out;
+    std::stringstream ss(line);
+    std::string item;
+    while (std::getline(ss, item, ',')) out.push_back(item);
+    return out;
+}
+
+int column(const std::vector<std::string>& header, const char* name) {
+    for (std::size_t i = 0; i < header.size(); ++i)
+        if (header[i] == name) return int(i);
+    return -1;
+}
+
+bool loadSamples(const std::string& path, const Options& opt, Samples& out) {
+    std::ifstream in(path);
+    if (!in) { std::fprintf(stderr, "No pude abrir %s\n", path.c_str()); return false; }
+    std::string line;
+    if (!std::getline(in, line)) { std::fprintf(stderr, "%s vacio\n", path.c_str()); return false; }
+    if (!line.empty() && line.back() == '\r') line.pop_back();
+    const std::vector<std::string> header = split(line);
+    const int cExec = column(header, "exec"), cMode = column(header, "mode");
+    const int cW = column(header, "width"), cH = column(header, "height");
+    const int cN = column(header, "N"), cThreads = column(header, "threads_req");
+    const int cFrame = column(header, "frame"), cMetric = column(header, opt.metric.c_str());
+    if (cExec < 0 || cMode < 0 || cW < 0 || cH < 0 || cN < 0 || cThreads < 0 || cFrame < 0 || cMetric < 0) {
+        std::fprintf(stderr, "%s: faltan columnas (exec, mode, width, height, N, threads_req, frame, %s)\n",
+                     path.c_str(), opt.metric.c_str());
+        return false;
+    }
+    const int need = std::max({ cExec, cMode, cW, cH, cN, cThreads, cFrame, cMetric }) + 1;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        const std::vector<std::string> f = split(line);
+        if (int(f.size()) < need) continue;
+        if (std::atoi(f[cFrame].c_str()) < opt.skip) continue;
+        GroupKey k{ f[cExec], f[cMode], std::atoi(f[cW].c_str()), std::atoi(f[cH].c_str()),
+                    std::atoi(f[cN].c_str()), std::atoi(f[cThreads].c_str()) };
+        out[k].push_back(std::atof(f[cMetric].c_str()));
+    }
+    return true;
+}
+
+std::string res(const GroupKey& k) {
+    return std::to_string(k.width) + "x" + std::to_string(k.height);
+}
+
+double median(std::vector<double> v) {
+    if (v.empty()) return 0.0;
+    const std::size_t m = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + m, v.end());
+    const double hi = v[m];
+    if (v.size() % 2) return hi;
+    return 0.5 * (hi + *std::max_element(v.begin(), v.begin() + m));
+}
+
+// p-valor unilateral de Mann-Whitney: P(U >= observado) con H0 = misma
+// distribucion; H1 = cand estocasticamente mayor que base
+double mannWhitneyGreater(const std::vector<double>& base, const std::vector<double>& cand) {
+    const std::size_t n1 = cand.size(), n2 = base.size(), n = n1 + n2;
+    std::vector<std::pair<double, int>> all;  // (valor, 1 = candidato)
+    all.reserve(n);
+    for (double x : cand) all.push_back({ x, 1 });
+    for (double x : base) all.push_back({ x, 0 });
+    std::sort(all.begin(), all.end());
+
+    // Rangos medios en los empates
+    double rankSumCand = 0.0, tieTerm = 0.0;
+    for (std::size_t i = 0; i < n;) {
+        std::size_t j = i;
+        while (j < n && all[j].first == all[i].first) ++j;
+        const double avgRank = 0.5 * double(i + 1 + j);
+        const double t = double(j - i);
+        tieTerm += t * t * t - t;
+        for (std::size_t k = i; k < j; ++k)
+            if (all[k].second) rankSumCand += avgRank;
+        i = j;
+    }
+    const double u = rankSumCand - double(n1) * double(n1 + 1) / 2.0;
+    const double mean = double(n1) * double(n2) / 2.0;
+    const double var = double(n1) * double(n2) / 12.0
+                     * (double(n + 1) - tieTerm / (double(n) * double(n - 1)));
+    if (var <= 0.0) return 1.0;  // todo empatado
+    const double z = (u - mean - 0.5) / std::sqrt(var);
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr,
+        "Uso: %s BASE.csv CAND.csv [--metric update_ms|render_ms|total_ms] [--threshold PCT]\n"
+        "       [--alpha A] [--skip K] [--min-frames M]\n", prog);
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    std::vector<std::string> pos;
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if      (a == "--metric" && hasValue)     opt.metric = argv[++i];
+        else if (a == "--threshold" && hasValue)  opt.thresholdPct = std::atof(argv[++i]);
+        else if (a == "--alpha" && hasValue)      opt.alpha = std::atof(argv[++i]);
+        else if (a == "--skip" && hasValue)       opt.skip = std::atoi(argv[++i]);
+        else if (a == "--min-frames" && hasValue) opt.minFrames = std::atoi(argv[++i]);
+        else if (!a.empty() && a[0] == '-')       return false;
+        else pos.push_back(a);
+    }
+    if (pos.size() != 2) return false;
+    if (opt.metric != "update_ms" && opt.metric != "render_ms" && opt.metric != "total_ms") return false;
+    if (opt.thresholdPct < 0.0 || opt.alpha <= 0.0 || opt.alpha >= 1.0 || opt.minFrames < 2) return false;
+    opt.basePath = pos[0];
+    opt.candPath = pos[1];
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) { usage(argv[0]); return 2; }
+
+    Samples base, cand;
+    if (!loadSamples(opt.basePath, opt, base) || !loadSamples(opt.candPath, opt, cand)) return 2;
+
+    std::printf("%s: base %s, candidato %s (umbral +%.1f%% en la mediana, alpha %.3g, --skip %d)\n\n",
+                opt.metric.c_str(), opt.basePath.c_str(), opt.candPath.c_str(),
+                opt.thresholdPct, opt.alpha, opt.skip);
+    std::printf("%-6s %-7s %9s %7s %4s %6s %6s %11s %11s %8s %9s  %s\n",
+                "exec", "mode", "res", "N", "hil", "n_base", "n_cand", "base_p50", "cand_p50",
+                "delta", "p", "veredicto");
+
+    int regressions = 0, compared = 0;
+    for (const auto& [key, b] : base) {
+        const auto it = cand.find(key);
+        std::printf("%-6s %-7s %9s %7d %4d %6zu ", key.exec.c_str(), key.mode.c_str(), res(key).c_str(),
+                    key.N, key.threads, b.size());
+        if (it == cand.end()) { std::printf("%6s %11s %11s %8s %9s  %s\n", "-", "-", "-", "-", "-", "sin candidato"); continue; }
+        const std::vector<double>& c = it->second;
+        const double mb = median(b), mc = median(c);
+        const double deltaPct = mb > 0.0 ? 100.0 * (mc - mb) / mb : 0.0;
+        std::printf("%6zu %11.4f %11.4f %+7.1f%% ", c.size(), mb, mc, deltaPct);
+        if (int(b.size()) < opt.minFrames || int(c.size()) < opt.minFrames) {
+            std::printf("%9s  %s\n", "-", "pocos frames");
+            continue;
+        }
+        ++compared;
+        const double pSlower = mannWhitneyGreater(b, c);
+        const double pFaster = mannWhitneyGreater(c, b);
+        const char* verdict = "igual";
+        if (pSlower < opt.alpha && deltaPct > opt.thresholdPct) { verdict = "REGRESION"; ++regressions; }
+        else if (pSlower < opt.alpha && deltaPct > 0.0)          verdict = "mas lento (bajo el umbral)";
+        else if (pFaster < opt.alpha && deltaPct < -opt.thresholdPct) verdict = "mas rapido";
+        std::printf("%9.2e  %s\n", deltaPct >= 0.0 ? pSlower : pFaster, verdict);
+    }
+    for (const auto& [key, c] : cand)
+        if (!base.count(key))
+            std::printf("%-6s %-7s %9s %7d %4d %6s %6zu %11s %11s %8s %9s  %s\n", key.exec.c_str(),
+                        key.mode.c_str(), res(key).c_str(), key.N, key.threads, "-", c.size(),
+                        "-", "-", "-", "-", "sin base");
+
+    std::printf("\n%d grupos comparados, %d regresiones\n", compared, regressions);
+    if (compared == 0) { std::fprintf(stderr, "Ningun grupo en comun entre base y candidato\n"); return 2; }
+    return regressions ? 1 : 0;
+}
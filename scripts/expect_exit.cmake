@@ -0,0 +1,9 @@
+# Corre un comando y comprueba su codigo de salida exacto (WILL_FAIL de ctest
+# acepta cualquier fallo: aqui 1 = regresion y 2 = entrada no valida son
+# resultados distintos). Lo usan los tests de bench_compare de CMakeLists.txt.
+#   -DCMD=programa|arg1|arg2... -DEXPECT=1
+string(REPLACE "|" ";" CMD "${CMD}")
+execute_process(COMMAND ${CMD} RESULT_VARIABLE rc)
+if(NOT rc EQUAL EXPECT)
+    message(FATAL_ERROR "Se esperaba salida ${EXPECT} y termino con ${rc}")
+endif()
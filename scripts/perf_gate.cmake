@@ -0,0 +1,28 @@
+# Compuerta de rendimiento: la invocan el objetivo perf_baseline y el test
+# perf_gate de CMakeLists.txt (cmake -P). Las listas llegan separadas por '|'.
+#   -DBIN=matrix_screensaver -DCOMPARE=bench_compare -DMODES=rain|nebula
+#   -DARGS=20000|--headless|... -DOUT=salida.csv [-DBASELINE=base.csv -DTHRESHOLD=5]
+# Corre BIN una vez por modo con ARGS y --bench OUT. Con BASELINE compara OUT
+# con la base y falla si bench_compare encuentra alguna regresion.
+string(REPLACE "|" ";" MODES "${MODES}")
+string(REPLACE "|" ";" ARGS "${ARGS}")
+
+file(REMOVE "${OUT}")
+foreach(mode IN LISTS MODES)
+    message(STATUS "perf: ${mode}")
+    execute_process(COMMAND "${BIN}" ${ARGS} --mode ${mode} --bench "${OUT}"
+                    RESULT_VARIABLE rc OUTPUT_QUIET)
+    if(NOT rc EQUAL 0)
+        message(FATAL_ERROR "${BIN} --mode ${mode} termino con ${rc}")
+    endif()
+endforeach()
+
+if(NOT BASELINE)
+    message(STATUS "Base escrita en ${OUT}")
+    return()
+endif()
+execute_process(COMMAND "${COMPARE}" "${BASELINE}" "${OUT}" --threshold ${THRESHOLD}
+                RESULT_VARIABLE rc)
+if(NOT rc EQUAL 0)
+    message(FATAL_ERROR "perf_gate: bench_compare termino con ${rc} (1 = regresion, 2 = entrada no valida)")
+endif()
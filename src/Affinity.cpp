@@ -0,0 +1,170 @@
+// src/Affinity.cpp
+#include "Affinity.h"
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+#include <tuple>
+
+#ifdef __linux__
+  #include <pthread.h>
+  #include <sched.h>
+#endif
+
+const char* pinModeName(PinMode m) {
+    switch (m) {
+        case PinMode::None:    return "none";
+        case PinMode::Compact: return "compact";
+        case PinMode::Scatter: return "scatter";
+        case PinMode::List:    return "list";
+    }
+    return "unknown";
+}
+
+bool parsePinSpec(const std::string& s, PinSpec& out) {
+    out = PinSpec{};
+    if (s == "none")    { out.mode = PinMode::None;    return true; }
+    if (s == "compact") { out.mode = PinMode::Compact; return true; }
+    if (s == "scatter") { out.mode = PinMode::Scatter; return true; }
+
+    // Lista: "0,2,4-7"
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (item.empty()) return false;
+        const std::size_t dash = item.find('-');
+        char* end = nullptr;
+        const long a = std::strtol(item.c_str(), &end, 10);
+        if (end == item.c_str() || a < 0) return false;
+        long b = a;
+        if (dash != std::string::npos) {
+            const char* p = item.c_str() + dash + 1;
+            b = std::strtol(p, &end, 10);
+            if (end == p || b < a) return false;
+        }
+        if (*end != '\0' || b > 4095) return false;
+        for (long c = a; c <= b; ++c) out.cpus.push_back(int(c));
+    }
+    if (out.cpus.empty()) return false;
+    out.mode = PinMode::List;
+    return true;
+}
+
+#ifdef __linux__
+namespace {
+
+std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof set, &set) != 0) return cpus;
+    for (int c = 0; c < CPU_SETSIZE; ++c)
+        if (CPU_ISSET(c, &set)) cpus.push_back(c);
+    return cpus;
+}
+
+int readSysInt(const std::string& path, int fallback) {
+    std::ifstream f(path);
+    int v;
+    return (f >> v) ? v : fallback;
+}
+
+// Nodo NUMA de la CPU: el enlace nodeK de su directorio (0 si no hay NUMA)
+int cpuNode(int cpu) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const fs::path dir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+    for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().filename().string();
+        if (name.size() > 4 && name.compare(0, 4, "node") == 0)
+            return std::atoi(name.c_str() + 4);
+    }
+    return 0;
+}
+
+struct CpuTopo {
+    int cpu, node, core, smt;  // smt: orden entre los hermanos del mismo nucleo
+    int coreRank;              // orden del nucleo dentro de su nodo
+};
+
+std::vector<CpuTopo> topology(const std::vector<int>& cpus) {
+    std::vector<CpuTopo> topo;
+    for (int c : cpus) {
+        const std::string base = "/sys/devices/system/cpu/cpu" + std::to_string(c) + "/topology/";
+        const int pkg  = readSysInt(base + "physical_package_id", 0);
+        const int core = readSysInt(base + "core_id", c);
+        // Nucleo unico en la maquina: paquete y core_id (core_id se repite entre paquetes)
+        topo.push_back({ c, cpuNode(c), pkg * 65536 + core, 0, 0 });
+    }
+    std::map<std::pair<int, int>, int> siblings;          // (nodo, nucleo) -> hermanos vistos
+    std::map<int, std::map<int, int>> coresByNode;        // nodo -> nucleo -> rango
+    for (CpuTopo& t : topo) {
+        t.smt = siblings[{ t.node, t.core }]++;
+        coresByNode[t.node].emplace(t.core, 0);
+    }
+    for (auto& [node, cores] : coresByNode) {
+        int r = 0;
+        for (auto& [core, rank] : cores) rank = r++;
+    }
+    for (CpuTopo& t : topo) t.coreRank = coresByNode[t.node][t.core];
+    return topo;
+}
+
+} // namespace
+#endif
+
+std::vector<int> pinOrder(const PinSpec& spec) {
+#ifdef __linux__
+    const std::vector<int> allowed = allowedCpus();
+    if (spec.mode == PinMode::None || allowed.empty()) return {};
+    if (spec.mode == PinMode::List) {
+        std::vector<int> cpus;
+        for (int c : spec.cpus)
+            if (std::find(allowed.begin(), allowed.end(), c) != allowed.end()) cpus.push_back(c);
+        return cpus;
+    }
+
+    std::vector<CpuTopo> topo = topology(allowed);
+    if (spec.mode == PinMode::Compact) {
+        std::sort(topo.begin(), topo.end(), [](const CpuTopo& a, const CpuTopo& b) {
+            return std::tie(a.node, a.coreRank, a.smt, a.cpu) < std::tie(b.node, b.coreRank, b.smt, b.cpu);
+        });
+    } else {
+        std::sort(topo.begin(), topo.end(), [](const CpuTopo& a, const CpuTopo& b) {
+            return std::tie(a.smt, a.coreRank, a.node, a.cpu) < std::tie(b.smt, b.coreRank, b.node, b.cpu);
+        });
+    }
+    std::vector<int> cpus;
+    for (const CpuTopo& t : topo) cpus.push_back(t.cpu);
+    return cpus;
+#else
+    (void)spec;
+    return {};
+#endif
+}
+
+bool pinCurrentThread(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(pthread_self(), sizeof set, &set) == 0;
+#else
+    (void)cpu;
+    return false;
+#endif
+}
+
+bool pinThread(std::thread& t, int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    return pthread_setaffinity_np(t.native_handle(), sizeof set, &set) == 0;
+#else
+    (void)t; (void)cpu;
+    return false;
+#endif
+}
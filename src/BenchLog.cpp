@@ -0,0 +1,111 @@
+// src/BenchLog.cpp
+#include "BenchLog.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <iostream>
+
+BenchLog::~BenchLog() { close(); }
+
+bool BenchLog::open(const std::string& path, const std::string& header, std::string prefix,
+                    std::size_t capacity) {
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    const bool newFile = !fs::exists(path, ec) || fs::file_size(path, ec) == 0;
+    if (!newFile) {
+        // Anadir filas bajo otra cabecera (CSV de una version con otras
+        // columnas) dejaria el fichero ilegible para analyze_bench
+        std::ifstream in(path);
+        std::string first;
+        std::getline(in, first);
+        if (!first.empty() && first.back() == '\r') first.pop_back();
+        if (first != header) {
+            std::cerr << path << " tiene otra cabecera (otra version de --bench): "
+                      << "usa otro fichero\n";
+            return false;
+        }
+    }
+    out_.open(path, std::ios::app);
+    if (!out_) { std::cerr << "No pude abrir " << path << "\n"; return false; }
+    if (newFile) out_ << header << '\n';
+
+    std::size_t cap = 1;
+    while (cap < capacity) cap <<= 1;
+    ring_.assign(cap, BenchRecord{});   // reserva y toca toda la memoria antes del bucle
+    mask_ = cap - 1;
+    prefix_ = std::move(prefix);
+    stop_ = false;
+    writer_ = std::thread([this] { writerLoop(); });
+    return true;
+}
+
+void BenchLog::push(const BenchRecord& r) {
+    const std::uint64_t h = head_.load(std::memory_order_relaxed);
+    if (h - tail_.load(std::memory_order_acquire) >= ring_.size()) {
+        ++fullWaits_;
+        cv_.notify_one();
+        while (h - tail_.load(std::memory_order_acquire) >= ring_.size()) std::this_thread::yield();
+    }
+    ring_[h & mask_] = r;
+    head_.store(h + 1, std::memory_order_release);
+    ++pushed_;
+    // Medio anillo pendiente: despertar antes del plazo del escritor (sin
+    // mutex: si el aviso se pierde, el plazo lo cubre)
+    if (((h + 1) & (mask_ >> 1)) == 0) cv_.notify_one();
+}
+
+void BenchLog::close() {
+    if (!writer_.joinable()) return;
+    { std::lock_guard<std::mutex> lk(m_); stop_ = true; }
+    cv_.notify_one();
+    writer_.join();
+    out_.close();
+}
+
+// Formatea lo pendiente en buf y lo escribe. false si no habia nada.
+bool BenchLog::drain(std::string& buf) {
+    const std::uint64_t h = head_.load(std::memory_order_acquire);
+    std::uint64_t t = tail_.load(std::memory_order_relaxed);
+    if (t == h) return false;
+
+    buf.clear();
+    char line[512];
+    for (; t != h; ++t) {
+        const BenchRecord& r = ring_[t & mask_];
+        const int len = std::snprintf(line, sizeof line,
+            "%s,%d,%.6f,%.3f,%.3f,%.3f,%.2f,%.4f,%.3f,%d,%.3f,%.2f,%d,%s,%.4f,%.4f,%.3f,%.4f,%.4f\n",
+            prefix_.c_str(), r.frame, double(r.dt), r.update_ms, r.render_ms, r.total_ms, r.fps,
+            r.forkjoin_ms, r.stall_ms, r.sim_steps, r.work_ewma_ms, double(r.detail), r.threads_cap,
+            r.budget_event, r.busy_max_ms, r.busy_mean_ms, r.imbalance, r.barrier_ms, r.log_ms);
+        buf.append(line, std::size_t(std::min<int>(len, int(sizeof line) - 1)));
+        // Liberar por tramos: un productor esperando no aguarda al bloque entero
+        if (((t + 1) & 255) == 0) tail_.store(t + 1, std::memory_order_release);
+    }
+    tail_.store(t, std::memory_order_release);
+    out_.write(buf.data(), std::streamsize(buf.size()));
+    return true;
+}
+
+void BenchLog::writerLoop() {
+    using clock_t = std::chrono::steady_clock;
+    std::string buf;
+    buf.reserve(ring_.size() * 160);
+    for (;;) {
+        bool stop;
+        {
+            std::unique_lock<std::mutex> lk(m_);
+            // Cada 50 ms, o antes si hay medio anillo pendiente o se cierra
+            cv_.wait_for(lk, std::chrono::milliseconds(50), [&] {
+                return stop_ || head_.load(std::memory_order_acquire)
+                              - tail_.load(std::memory_order_relaxed) >= ring_.size() / 2;
+            });
+            stop = stop_;
+        }
+        const auto t0 = clock_t::now();
+        while (drain(buf)) {}
+        out_.flush();
+        writerMs_ += std::chrono::duration<double, std::milli>(clock_t::now() - t0).count();
+        if (stop) break;
+    }
+}
@@ -137,6 +137,25 @@ void ObjModel::drawProjected(sf::RenderWindow& window,
                              sf::Color color) {
     if (!loaded_) return;
 
+    // 1-2) Rotación y proyección a vtx2d_
+    project(center, scale, angleY);
+
+    // 3) Construir VertexArray (2 vértices por arista) y dibujar 1 vez
+    for (size_t k = 0; k < edges_.size(); ++k) {
+        auto [a, b] = edges_[k];
+        sf::Vertex& v0 = lines_[2 * k + 0];
+        sf::Vertex& v1 = lines_[2 * k + 1];
+        v0.position = vtx2d_[a];
+        v1.position = vtx2d_[b];
+        v0.color = color;
+        v1.color = color;
+    }
+    window.draw(lines_);
+}
+
+void ObjModel::project(sf::Vector2f center, float scale, float angleY) {
+    if (!loaded_) return;
+
     // 1) Rotación Y (una sola sin/cos)
     float c = std::cos(angleY);
     float s = std::sin(angleY);
@@ -155,16 +174,4 @@ void ObjModel::drawProjected(sf::RenderWindow& window,
         vtx2d_[i].x = center.x + (v.x * scale) * w;
         vtx2d_[i].y = center.y + (v.y * scale) * w;
     }
-
-    // 3) Construir VertexArray (2 vértices por arista) y dibujar 1 vez
-    for (size_t k = 0; k < edges_.size(); ++k) {
-        auto [a, b] = edges_[k];
-        sf::Vertex& v0 = lines_[2 * k + 0];
-        sf::Vertex& v1 = lines_[2 * k + 1];
-        v0.position = vtx2d_[a];
-        v1.position = vtx2d_[b];
-        v0.color = color;
-        v1.color = color;
-    }
-    window.draw(lines_);
 }
@@ -0,0 +1,125 @@
+// src/Parallel.cpp
+#include "Parallel.h"
+#include <cstdint>
+#include "Affinity.h"
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+const char* backendName(Backend b) {
+    switch (b) {
+        case Backend::Omp:    return "omp";
+        case Backend::Pool:   return "pool";
+        case Backend::Serial: return "seq";
+    }
+    return "unknown";
+}
+
+namespace {
+
+class SerialBackend final : public ParallelBackend {
+public:
+    Backend kind() const override { return Backend::Serial; }
+    int threads() const override { return 1; }
+    int run(int parts, const PartFn& f) override {
+        for (int p = 0; p < parts; ++p) f(p);
+        return 1;
+    }
+    int pin(const std::vector<int>& cpus) override {
+        return (!cpus.empty() && pinCurrentThread(cpus[0])) ? 1 : 0;
+    }
+};
+
+#ifdef _OPENMP
+// Equipo segun las ICV del hilo llamador (omp_set_num_threads es por hilo:
+// el de --pipeline fija las suyas). Si el runtime da menos hilos que partes,
+// cada hilo recorre varias.
+class OmpBackend final : public ParallelBackend {
+public:
+    Backend kind() const override { return Backend::Omp; }
+    int threads() const override { return omp_get_max_threads(); }
+    int run(int parts, const PartFn& f) override {
+        if (parts <= 1) {
+            if (parts == 1) f(0);
+            return 1;
+        }
+        int team = 1;
+        #pragma omp parallel num_threads(parts)
+        {
+            const int t = omp_get_thread_num(), nth = omp_get_num_threads();
+            if (t == 0) team = nth;
+            for (int p = t; p < parts; p += nth) f(p);
+        }
+        return team;
+    }
+    int pin(const std::vector<int>& cpus) override {
+        if (cpus.empty()) return 0;
+        const int n = int(cpus.size());
+        int pinned = 0;
+        #pragma omp parallel num_threads(threads()) reduction(+:pinned)
+        pinned += pinCurrentThread(cpus[omp_get_thread_num() % n]) ? 1 : 0;
+        return pinned;
+    }
+};
+#endif
+
+// Una parte por trabajo: el llamador encola las demas en su cola, ejecuta la
+// 0 y luego ayuda (roba) hasta que terminan. Desde un hilo del pool (p.ej. una
+// tarea de --taskgraph) el despacho queda anidado sin bloquear a nadie.
+// Devuelve cuantas ranuras distintas ejecutaron alguna parte (un bit por
+// ranura; el mapa va en la pila salvo en pools de mas de 256 hilos).
+class PoolBackend final : public ParallelBackend {
+public:
+    explicit PoolBackend(WorkPool& pool) : pool_(pool) {}
+    Backend kind() const override { return Backend::Pool; }
+    int threads() const override { return pool_.size(); }
+    int run(int parts, const PartFn& f) override {
+        if (parts <= 1) {
+            if (parts == 1) f(0);
+            return 1;
+        }
+        const std::size_t words = (std::size_t(pool_.size()) + 63) / 64;
+        std::atomic<std::uint64_t> local[kLocalWords] = {};
+        std::unique_ptr<std::atomic<std::uint64_t>[]> heap;
+        if (words > kLocalWords) heap.reset(new std::atomic<std::uint64_t>[words]());
+        Dispatch d{ &f, {parts}, heap ? heap.get() : local };
+        // Acotada como en push: la ranura indexa tambien el mapa
+        const int w = std::clamp(WorkPool::currentWorker(), 0, pool_.size() - 1);
+        for (int p = parts - 1; p >= 1; --p)
+            pool_.push({ &PoolBackend::runPart, &d, std::size_t(p) }, w);
+        runPart(&d, 0, w);
+        pool_.help(d.left);
+        int team = 0;
+        for (std::size_t i = 0; i < words; ++i)
+            for (std::uint64_t m = d.seen[i].load(std::memory_order_relaxed); m; m &= m - 1) ++team;
+        return std::max(1, team);
+    }
+    int pin(const std::vector<int>& cpus) override { return pool_.pin(cpus); }
+
+private:
+    static constexpr std::size_t kLocalWords = 4;
+    struct Dispatch {
+        const PartFn* f;
+        std::atomic<int> left;
+        std::atomic<std::uint64_t>* seen;  // ranuras que ejecutaron alguna parte
+    };
+    static void runPart(void* ctx, std::size_t part, int worker) {
+        Dispatch& d = *static_cast<Dispatch*>(ctx);
+        d.seen[worker / 64].fetch_or(std::uint64_t(1) << (worker % 64), std::memory_order_relaxed);
+        (*d.f)(int(part));
+        d.left.fetch_sub(1, std::memory_order_release);
+    }
+
+    WorkPool& pool_;
+};
+
+} // namespace
+
+std::unique_ptr<ParallelBackend> makeParallelBackend(Backend kind, WorkPool* pool) {
+    if (kind == Backend::Pool && pool) return std::make_unique<PoolBackend>(*pool);
+#ifdef _OPENMP
+    if (kind == Backend::Omp) return std::make_unique<OmpBackend>();
+#endif
+    return std::make_unique<SerialBackend>();
+}
@@ -0,0 +1,44 @@
+// src/SimdKernels.cpp — seleccion de kernel en tiempo de ejecucion
+#include "SimdKernels.h"
+
+const char* simdKernelName(SimdKernel k) {
+    switch (k) {
+        case SimdKernel::Scalar: return "scalar";
+        case SimdKernel::Sse41:  return "sse4.1";
+        case SimdKernel::Avx2:   return "avx2";
+        case SimdKernel::Auto:   return "auto";
+    }
+    return "unknown";
+}
+
+#if defined(MATRIX_SIMD_X86)
+// Solo lo consulta resolveSimdKernels en x86
+static bool cpuHas(SimdKernel k) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_cpu_init();
+    if (k == SimdKernel::Avx2)  return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    if (k == SimdKernel::Sse41) return __builtin_cpu_supports("sse4.1");
+#endif
+    return k == SimdKernel::Scalar;
+}
+#endif
+
+SimdKernelSet resolveSimdKernels(SimdKernel requested) {
+    SimdKernelSet set;
+#if defined(MATRIX_SIMD_X86)
+    const bool wantAvx2 = (requested == SimdKernel::Auto || requested == SimdKernel::Avx2);
+    const bool wantSse  = wantAvx2 || requested == SimdKernel::Sse41;
+    if (wantAvx2 && cpuHas(SimdKernel::Avx2)) {
+        set.kind = SimdKernel::Avx2;
+        set.spiral = spiralKernelAvx2;
+        set.nebula = nebulaKernelAvx2;
+    } else if (wantSse && cpuHas(SimdKernel::Sse41)) {
+        set.kind = SimdKernel::Sse41;
+        set.spiral = spiralKernelSse41;
+        set.nebula = nebulaKernelSse41;
+    }
+#else
+    (void)requested;
+#endif
+    return set;
+}
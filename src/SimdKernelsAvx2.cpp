@@ -0,0 +1,54 @@
+// src/SimdKernelsAvx2.cpp — compilado con -mavx2 -mfma (ver CMakeLists.txt)
+#include "SimdKernels.h"
+
+#if defined(MATRIX_SIMD_X86) && defined(__AVX2__) && defined(__FMA__)
+#include <immintrin.h>
+
+namespace {
+struct Avx2V {
+    static constexpr int W = 8;
+    using F = __m256; using I = __m256i; using M = __m256;
+    static F set1(float x) { return _mm256_set1_ps(x); }
+    static I set1i(std::int32_t x) { return _mm256_set1_epi32(x); }
+    static F load(const float* p) { return _mm256_loadu_ps(p); }
+    static void store(float* p, F v) { _mm256_storeu_ps(p, v); }
+    static I loadu32(const std::uint32_t* p) { return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)); }
+    static void storeu32(std::uint32_t* p, I v) { _mm256_storeu_si256(reinterpret_cast<__m256i*>(p), v); }
+    static F add(F a, F b) { return _mm256_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm256_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm256_mul_ps(a, b); }
+    static F div(F a, F b) { return _mm256_div_ps(a, b); }
+    static F fma(F a, F b, F c) { return _mm256_fmadd_ps(a, b, c); }
+    static F min(F a, F b) { return _mm256_min_ps(a, b); }
+    static F max(F a, F b) { return _mm256_max_ps(a, b); }
+    static F sqrt(F a) { return _mm256_sqrt_ps(a); }
+    static F abs(F a) { return _mm256_andnot_ps(_mm256_set1_ps(-0.f), a); }
+    static F floor(F a) { return _mm256_floor_ps(a); }
+    static F round(F a) { return _mm256_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static M lt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    static M gt(F a, F b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    static F select(M m, F a, F b) { return _mm256_blendv_ps(b, a, m); }
+    static I cvti(F a) { return _mm256_cvtps_epi32(a); }
+    static I cvtti(F a) { return _mm256_cvttps_epi32(a); }
+    static F cvtf(I a) { return _mm256_cvtepi32_ps(a); }
+    static I andi(I a, I b) { return _mm256_and_si256(a, b); }
+    static I ori(I a, I b) { return _mm256_or_si256(a, b); }
+    static I addi(I a, I b) { return _mm256_add_epi32(a, b); }
+    template <int S> static I shli(I a) { return _mm256_slli_epi32(a, S); }
+    static M bitset(I a, std::int32_t bit) {
+        const I b = _mm256_set1_epi32(bit);
+        return _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(a, b), b));
+    }
+};
+} // namespace
+
+#include "SimdKernelsImpl.h"
+
+void spiralKernelAvx2(const SpiralKernelArgs& a, std::size_t begin, std::size_t end) {
+    runSpiral<Avx2V>(a, begin, end);
+}
+
+void nebulaKernelAvx2(const NebulaKernelArgs& a, std::size_t begin, std::size_t end) {
+    runNebula<Avx2V>(a, begin, end);
+}
+#endif
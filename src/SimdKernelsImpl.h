@@ -0,0 +1,232 @@
+// src/SimdKernelsImpl.h
+// Cuerpo comun de los kernels SIMD. Lo incluye cada TU de ISA despues de
+// definir su struct de rasgos V (ancho W, tipos F/I/M y operaciones). Todo vive
+// en un namespace anonimo: cada TU compila su propia copia con sus flags y no
+// hay simbolos compartidos entre TUs con ISAs distintas (ODR).
+#pragma once
+#include "SimdKernels.h"
+#include <cstdint>
+#include <cstddef>
+#include <cmath>
+#include <algorithm>
+
+namespace {
+
+// Rasgos escalares (W = 1): cola de cada kernel con la misma aritmetica
+struct ScalarV {
+    static constexpr int W = 1;
+    using F = float; using I = std::int32_t; using M = bool;
+    static F set1(float x) { return x; }
+    static I set1i(std::int32_t x) { return x; }
+    static F load(const float* p) { return *p; }
+    static void store(float* p, F v) { *p = v; }
+    static I loadu32(const std::uint32_t* p) { return std::int32_t(*p); }
+    static void storeu32(std::uint32_t* p, I v) { *p = std::uint32_t(v); }
+    static F add(F a, F b) { return a + b; }
+    static F sub(F a, F b) { return a - b; }
+    static F mul(F a, F b) { return a * b; }
+    static F div(F a, F b) { return a / b; }
+    static F fma(F a, F b, F c) { return a * b + c; }
+    static F min(F a, F b) { return std::min(a, b); }
+    static F max(F a, F b) { return std::max(a, b); }
+    static F sqrt(F a) { return std::sqrt(a); }
+    static F abs(F a) { return std::fabs(a); }
+    static F floor(F a) { return std::floor(a); }
+    static F round(F a) { return std::nearbyint(a); }
+    static M lt(F a, F b) { return a < b; }
+    static M gt(F a, F b) { return a > b; }
+    static F select(M m, F a, F b) { return m ? a : b; }
+    static I cvti(F a) { return std::int32_t(std::nearbyint(a)); }
+    static I cvtti(F a) { return std::int32_t(a); }
+    static F cvtf(I a) { return float(a); }
+    static I andi(I a, I b) { return a & b; }
+    static I ori(I a, I b) { return a | b; }
+    static I addi(I a, I b) { return a + b; }
+    template <int S> static I shli(I a) { return std::int32_t(std::uint32_t(a) << S); }
+    static M bitset(I a, std::int32_t bit) { return (a & bit) != 0; }
+};
+
+// ---------------- sin/cos polinomial ----------------
+// q = round(x * 2/pi); r = x - q*pi/2 (Cody-Waite 3 partes) en [-pi/4, pi/4].
+template <class V>
+inline void sincosPoly(typename V::F x, typename V::F& s, typename V::F& c) {
+    using F = typename V::F; using I = typename V::I;
+    const F q  = V::round(V::mul(x, V::set1(0.636619772367581343f)));
+    const I qi = V::cvti(q);
+    F r = V::fma(q, V::set1(-1.5703125f), x);
+    r = V::fma(q, V::set1(-4.837512969970703125e-4f), r);
+    r = V::fma(q, V::set1(-7.54978995489188216e-8f), r);
+
+    const F r2 = V::mul(r, r);
+    // sin(r) ~ r + r^3 (S1 + r^2 (S2 + r^2 S3))
+    F ps = V::fma(r2, V::set1(-1.9515295891e-4f), V::set1(8.3321608736e-3f));
+    ps = V::fma(r2, ps, V::set1(-1.6666654611e-1f));
+    ps = V::fma(V::mul(r2, r), ps, r);
+    // cos(r) ~ 1 - r^2/2 + r^4 (C1 + r^2 (C2 + r^2 C3))
+    F pc = V::fma(r2, V::set1(2.443315711809948e-5f), V::set1(-1.388731625493765e-3f));
+    pc = V::fma(r2, pc, V::set1(4.166664568298827e-2f));
+    pc = V::fma(V::mul(r2, r2), pc, V::fma(r2, V::set1(-0.5f), V::set1(1.f)));
+
+    // Cuadrante: q&1 intercambia sin/cos; signos por q&2 y (q+1)&2
+    const auto swap = V::bitset(qi, 1);
+    F sv = V::select(swap, pc, ps);
+    F cv = V::select(swap, ps, pc);
+    sv = V::select(V::bitset(qi, 2), V::sub(V::set1(0.f), sv), sv);
+    cv = V::select(V::bitset(V::addi(qi, V::set1i(1)), 2), V::sub(V::set1(0.f), cv), cv);
+    s = sv; c = cv;
+}
+
+template <class V>
+inline typename V::F sinPoly(typename V::F x) {
+    typename V::F s, c;
+    sincosPoly<V>(x, s, c);
+    return s;
+}
+
+template <class V>
+inline typename V::F cosPoly(typename V::F x) {
+    typename V::F s, c;
+    sincosPoly<V>(x, s, c);
+    return c;
+}
+
+template <class V>
+inline typename V::F clampV(typename V::F x, float lo, float hi) {
+    return V::min(V::max(x, V::set1(lo)), V::set1(hi));
+}
+
+// ---------------- Spiral ----------------
+template <class V>
+inline void spiralStep(const SpiralKernelArgs& a, std::size_t i) {
+    using F = typename V::F; using I = typename V::I;
+    const F dt = V::set1(a.dt);
+
+    const F angle = V::fma(V::load(a.angVel + i), dt, V::load(a.angle + i));
+    V::store(a.angle + i, angle);
+    const F arg = V::fma(angle, V::set1(0.9f), V::load(a.phase + i));
+    const F r = V::fma(V::load(a.radiusAmp + i), sinPoly<V>(arg), V::load(a.baseRadius + i));
+
+    F zVel = V::load(a.zVel + i);
+    F z = V::fma(zVel, dt, V::load(a.z + i));
+    const F Zmax = V::set1(350.f);
+    const auto hi = V::gt(z, Zmax);
+    const auto lo = V::lt(z, V::sub(V::set1(0.f), Zmax));
+    z = V::select(hi, Zmax, V::select(lo, V::sub(V::set1(0.f), Zmax), z));
+    zVel = V::select(hi, V::sub(V::set1(0.f), V::abs(zVel)), V::select(lo, V::abs(zVel), zVel));
+    V::store(a.z + i, z);
+    V::store(a.zVel + i, zVel);
+
+    F sa, ca;
+    sincosPoly<V>(angle, sa, ca);
+    const F f = V::set1(500.f);
+    const F s = V::div(f, V::add(f, z));
+    V::store(a.outX + i, V::fma(V::mul(r, ca), s, V::set1(a.cx)));
+    V::store(a.outY + i, V::fma(V::mul(r, sa), s, V::set1(a.cy + 25.f * a.dt)));
+
+    const F uiScale = clampV<V>(s, 0.5f, 1.8f);
+    V::store(a.outCharSize + i,
+             V::floor(V::max(V::set1(8.f), V::mul(V::load(a.baseSize + i), uiScale))));
+
+    const F alpha = clampV<V>(V::fma(V::sub(s, V::set1(1.f)), V::set1(70.f), V::set1(180.f)), 60.f, 255.f);
+    const I rgb = V::andi(V::loadu32(a.outRgba + i), V::set1i(std::int32_t(0xFFFFFF00u)));
+    V::storeu32(a.outRgba + i, V::ori(rgb, V::cvtti(alpha)));
+}
+
+// ---------------- Nebula ----------------
+// Igual que TextRender::nebulaColor: rampa de 4 paradas, canales redondeados
+template <class V>
+inline typename V::I nebulaRgba(typename V::F t01, typename V::F alpha) {
+    using F = typename V::F; using I = typename V::I;
+    const F t = clampV<V>(t01, 0.f, 1.f);
+    const auto s0 = V::lt(t, V::set1(0.33f));
+    const auto s1 = V::lt(t, V::set1(0.66f));
+    const F tt = V::select(s0, V::div(t, V::set1(0.33f)),
+                  V::select(s1, V::div(V::sub(t, V::set1(0.33f)), V::set1(0.33f)),
+                                V::div(V::sub(t, V::set1(0.66f)), V::set1(0.34f))));
+    auto channel = [&](float a, float b, float c, float d) {
+        const F u = V::select(s0, V::set1(a), V::select(s1, V::set1(b), V::set1(c)));
+        const F v = V::select(s0, V::set1(b), V::select(s1, V::set1(c), V::set1(d)));
+        return V::cvtti(V::floor(V::add(V::fma(V::sub(v, u), tt, u), V::set1(0.5f))));
+    };
+    const I r = channel(80.f, 180.f, 255.f, 255.f);
+    const I g = channel(0.f, 30.f, 60.f, 160.f);
+    const I b = channel(0.f, 30.f, 60.f, 60.f);
+    const I al = V::cvtti(clampV<V>(V::floor(V::add(alpha, V::set1(0.5f))), 0.f, 255.f));
+    return V::ori(V::ori(V::template shli<24>(r), V::template shli<16>(g)),
+                  V::ori(V::template shli<8>(b), al));
+}
+
+template <class V>
+inline void nebulaStep(const NebulaKernelArgs& a, std::size_t i) {
+    using F = typename V::F;
+    const F dt = V::set1(a.dt);
+    const F seed = V::load(a.noiseSeed + i);
+
+    const F fx = V::mul(V::set1(12.f), sinPoly<V>(V::fma(seed, V::set1(0.71f), V::set1(0.08f * a.time))));
+    const F fy = V::mul(V::set1(12.f), cosPoly<V>(V::fma(seed, V::set1(1.31f), V::set1(0.11f * a.time))));
+    F vx = V::fma(fx, dt, V::load(a.velX + i));
+    F vy = V::fma(fy, dt, V::load(a.velY + i));
+
+    const F vmax = V::set1(a.vmax);
+    const F vlen = V::sqrt(V::fma(vx, vx, V::mul(vy, vy)));
+    const auto fast = V::gt(vlen, vmax);
+    const F k = V::select(fast, V::div(vmax, vlen), V::set1(1.f));
+    vx = V::mul(vx, k);
+    vy = V::mul(vy, k);
+    V::store(a.velX + i, vx);
+    V::store(a.velY + i, vy);
+
+    const F px = V::fma(vx, dt, V::load(a.posX + i));
+    const F py = V::fma(vy, dt, V::load(a.posY + i));
+    V::store(a.posX + i, px);
+    V::store(a.posY + i, py);
+
+    const F spin = V::fma(V::load(a.spinVelDeg + i), dt, V::load(a.spinDeg + i));
+    V::store(a.spinDeg + i, spin);
+
+    // Rebote de escala y alpha en sus limites (invierte el signo de la velocidad)
+    auto bounce = [&](float* val, float* vel, float lo, float hi) {
+        F w = V::load(vel + i);
+        F x = V::fma(w, dt, V::load(val + i));
+        const auto under = V::lt(x, V::set1(lo));
+        const auto over  = V::gt(x, V::set1(hi));
+        x = V::select(under, V::set1(lo), V::select(over, V::set1(hi), x));
+        w = V::select(under, V::abs(w), V::select(over, V::sub(V::set1(0.f), V::abs(w)), w));
+        V::store(val + i, x);
+        V::store(vel + i, w);
+        return x;
+    };
+    const F scale = bounce(a.scale, a.scaleVel, 0.7f, 1.4f);
+    const F alpha = bounce(a.alpha, a.alphaVel, 90.f, 255.f);
+
+    const F t01 = V::fma(sinPoly<V>(V::fma(seed, V::set1(0.9f), V::set1(0.7f * a.time))),
+                         V::set1(0.5f), V::set1(0.5f));
+    V::storeu32(a.outRgba + i, nebulaRgba<V>(t01, alpha));
+    V::store(a.outX + i, px);
+    V::store(a.outY + i, py);
+    V::store(a.outRot + i, spin);
+    V::store(a.outScale + i, scale);
+}
+
+// 2 vectores por iteracion; cola escalar con la misma aritmetica
+template <class V>
+inline void runSpiral(const SpiralKernelArgs& a, std::size_t begin, std::size_t end) {
+    std::size_t i = begin;
+    for (; i + 2 * V::W <= end; i += 2 * V::W) {
+        spiralStep<V>(a, i);
+        spiralStep<V>(a, i + V::W);
+    }
+    for (; i < end; ++i) spiralStep<ScalarV>(a, i);
+}
+
+template <class V>
+inline void runNebula(const NebulaKernelArgs& a, std::size_t begin, std::size_t end) {
+    std::size_t i = begin;
+    for (; i + 2 * V::W <= end; i += 2 * V::W) {
+        nebulaStep<V>(a, i);
+        nebulaStep<V>(a, i + V::W);
+    }
+    for (; i < end; ++i) nebulaStep<ScalarV>(a, i);
+}
+
+} // namespace
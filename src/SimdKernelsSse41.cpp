@@ -0,0 +1,54 @@
+// src/SimdKernelsSse41.cpp — compilado con -msse4.1 (ver CMakeLists.txt)
+#include "SimdKernels.h"
+
+#if defined(MATRIX_SIMD_X86) && defined(__SSE4_1__)
+#include <smmintrin.h>
+
+namespace {
+struct Sse41V {
+    static constexpr int W = 4;
+    using F = __m128; using I = __m128i; using M = __m128;
+    static F set1(float x) { return _mm_set1_ps(x); }
+    static I set1i(std::int32_t x) { return _mm_set1_epi32(x); }
+    static F load(const float* p) { return _mm_loadu_ps(p); }
+    static void store(float* p, F v) { _mm_storeu_ps(p, v); }
+    static I loadu32(const std::uint32_t* p) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p)); }
+    static void storeu32(std::uint32_t* p, I v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(p), v); }
+    static F add(F a, F b) { return _mm_add_ps(a, b); }
+    static F sub(F a, F b) { return _mm_sub_ps(a, b); }
+    static F mul(F a, F b) { return _mm_mul_ps(a, b); }
+    static F div(F a, F b) { return _mm_div_ps(a, b); }
+    static F fma(F a, F b, F c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    static F min(F a, F b) { return _mm_min_ps(a, b); }
+    static F max(F a, F b) { return _mm_max_ps(a, b); }
+    static F sqrt(F a) { return _mm_sqrt_ps(a); }
+    static F abs(F a) { return _mm_andnot_ps(_mm_set1_ps(-0.f), a); }
+    static F floor(F a) { return _mm_floor_ps(a); }
+    static F round(F a) { return _mm_round_ps(a, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC); }
+    static M lt(F a, F b) { return _mm_cmplt_ps(a, b); }
+    static M gt(F a, F b) { return _mm_cmpgt_ps(a, b); }
+    static F select(M m, F a, F b) { return _mm_blendv_ps(b, a, m); }
+    static I cvti(F a) { return _mm_cvtps_epi32(a); }
+    static I cvtti(F a) { return _mm_cvttps_epi32(a); }
+    static F cvtf(I a) { return _mm_cvtepi32_ps(a); }
+    static I andi(I a, I b) { return _mm_and_si128(a, b); }
+    static I ori(I a, I b) { return _mm_or_si128(a, b); }
+    static I addi(I a, I b) { return _mm_add_epi32(a, b); }
+    template <int S> static I shli(I a) { return _mm_slli_epi32(a, S); }
+    static M bitset(I a, std::int32_t bit) {
+        const I b = _mm_set1_epi32(bit);
+        return _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(a, b), b));
+    }
+};
+} // namespace
+
+#include "SimdKernelsImpl.h"
+
+void spiralKernelSse41(const SpiralKernelArgs& a, std::size_t begin, std::size_t end) {
+    runSpiral<Sse41V>(a, begin, end);
+}
+
+void nebulaKernelSse41(const NebulaKernelArgs& a, std::size_t begin, std::size_t end) {
+    runNebula<Sse41V>(a, begin, end);
+}
+#endif
@@ -0,0 +1,69 @@
+// src/SpatialGrid.cpp
+#include "SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+int SpatialGrid::cellX(float x) const {
+    return std::clamp(int(x * inv_), 0, cols_ - 1);
+}
+
+int SpatialGrid::cellY(float y) const {
+    return std::clamp(int(y * inv_), 0, rows_ - 1);
+}
+
+void SpatialGrid::build(const float* x, const float* y, int n, float cellSize,
+                        sf::Vector2u world, ParallelBackend& par, int parts, int& team) {
+    cell_ = std::max(1.f, cellSize);
+    inv_  = 1.f / cell_;
+    cols_ = std::max(1, int(std::ceil(float(world.x) * inv_)));
+    rows_ = std::max(1, int(std::ceil(float(world.y) * inv_)));
+    const int C = cols_ * rows_;
+
+    parts = std::max(1, parts);
+    cellOf_.resize(n);
+    order_.resize(n);
+    start_.assign(std::size_t(C) + 1, 0);
+    hist_.assign(std::size_t(parts) * C, 0);
+
+    // Misma particion estatica en conteo y dispersion: orden estable
+    team = par.run(parts, [&](int p) {
+        std::size_t b, e;
+        partRange(std::size_t(n), p, parts, b, e);
+        int* h = &hist_[std::size_t(p) * C];
+        for (int i = int(b); i < int(e); ++i) {
+            const int c = cellY(y[i]) * cols_ + cellX(x[i]);
+            cellOf_[i] = c;
+            ++h[c];
+        }
+    });
+
+    // Por celda: desplazamiento de cada parte dentro de la celda + total
+    par.run(parts, [&](int p) {
+        std::size_t b, e;
+        partRange(std::size_t(C), p, parts, b, e);
+        for (int c = int(b); c < int(e); ++c) {
+            int sum = 0;
+            for (int pp = 0; pp < parts; ++pp) {
+                int& v = hist_[std::size_t(pp) * C + c];
+                const int cnt = v;
+                v = sum;
+                sum += cnt;
+            }
+            start_[c + 1] = sum;
+        }
+    });
+
+    // Prefijo entre celdas (O(celdas), muy por debajo de N)
+    for (int c = 0; c < C; ++c) start_[c + 1] += start_[c];
+
+    par.run(parts, [&](int p) {
+        std::size_t b, e;
+        partRange(std::size_t(n), p, parts, b, e);
+        int* h = &hist_[std::size_t(p) * C];
+        for (int i = int(b); i < int(e); ++i) {
+            const int c = cellOf_[i];
+            order_[start_[c] + h[c]++] = i;
+        }
+    });
+}
@@ -0,0 +1,142 @@
+// src/TaskGraph.cpp
+#include "TaskGraph.h"
+#include <algorithm>
+#include <chrono>
+
+static inline double nowMs() {
+    return std::chrono::duration<double, std::milli>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int TaskGraph::add(const char* name, Body body, std::vector<int> deps,
+                   std::size_t n, std::size_t grain) {
+    const int id = int(nodes_.size());
+    auto node = std::make_unique<Node>();
+    node->name  = name;
+    node->body  = std::move(body);
+    node->deps  = std::move(deps);
+    node->n     = n;
+    node->grain = std::max<std::size_t>(1, grain);
+    node->firstChunk = int(chunks_.size());
+    node->nChunks    = int((n + node->grain - 1) / node->grain);
+    for (int d : node->deps) nodes_[d]->succ.push_back(id);
+
+    for (int c = 0; c < node->nChunks; ++c) {
+        Chunk ch;
+        ch.node  = id;
+        ch.begin = std::size_t(c) * node->grain;
+        ch.end   = std::min(n, ch.begin + node->grain);
+        chunks_.push_back(ch);
+    }
+    nodes_.push_back(std::move(node));
+    return id;
+}
+
+void TaskGraph::clear() {
+    nodes_.clear();
+    chunks_.clear();
+}
+
+void TaskGraph::run(WorkPool& pool) {
+    pool_ = &pool;
+    for (auto& node : nodes_) {
+        node->depsLeft.store(int(node->deps.size()), std::memory_order_relaxed);
+        node->chunksLeft.store(node->nChunks, std::memory_order_relaxed);
+    }
+    remaining_.store(int(chunks_.size()), std::memory_order_relaxed);
+    origin_ = nowMs();
+
+    for (int id = 0; id < size(); ++id)
+        if (nodes_[id]->deps.empty()) release(id);
+    pool.help(remaining_);
+    finishStats();
+}
+
+// Tarea lista: encola sus subtareas (o, si el rango esta vacio, la da por
+// terminada y libera a sus sucesoras)
+void TaskGraph::release(int id) {
+    Node& node = *nodes_[id];
+    if (node.nChunks == 0) {
+        for (int s : node.succ)
+            if (nodes_[s]->depsLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) release(s);
+        return;
+    }
+    const int w = WorkPool::currentWorker();
+    for (int c = 0; c < node.nChunks; ++c)
+        pool_->push({ &TaskGraph::runChunk, this, std::size_t(node.firstChunk + c) }, w);
+}
+
+void TaskGraph::runChunk(void* ctx, std::size_t chunk, int worker) {
+    TaskGraph& g = *static_cast<TaskGraph*>(ctx);
+    Chunk& c = g.chunks_[chunk];
+    Node& node = *g.nodes_[c.node];
+
+    c.worker = worker;
+    c.t0 = nowMs();
+    node.body(c.begin, c.end);
+    c.t1 = nowMs();
+
+    if (node.chunksLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+        for (int s : node.succ)
+            if (g.nodes_[s]->depsLeft.fetch_sub(1, std::memory_order_acq_rel) == 1) g.release(s);
+    }
+    g.remaining_.fetch_sub(1, std::memory_order_release);
+}
+
+// Ruta critica: desde la tarea que termina ultima, se retrocede por la
+// dependencia que termino mas tarde (la que de verdad retraso el inicio)
+void TaskGraph::finishStats() {
+    makespanMs_ = 0.0;
+    for (auto& node : nodes_) {
+        Stats& st = node->stats;
+        st = Stats{};
+        st.chunks = node->nChunks;
+        if (node->nChunks == 0) continue;
+        std::vector<int> seen;
+        st.startMs = 1e300;
+        for (int c = node->firstChunk; c < node->firstChunk + node->nChunks; ++c) {
+            const Chunk& ch = chunks_[c];
+            st.startMs = std::min(st.startMs, ch.t0 - origin_);
+            st.endMs   = std::max(st.endMs, ch.t1 - origin_);
+            st.busyMs += ch.t1 - ch.t0;
+            if (std::find(seen.begin(), seen.end(), ch.worker) == seen.end()) seen.push_back(ch.worker);
+        }
+        st.workers = int(seen.size());
+        makespanMs_ = std::max(makespanMs_, st.endMs);
+    }
+
+    criticalMs_ = 0.0;
+    int cur = -1;
+    for (int id = 0; id < size(); ++id)
+        if (cur < 0 || nodes_[id]->stats.endMs > nodes_[cur]->stats.endMs) cur = id;
+    while (cur >= 0) {
+        Stats& st = nodes_[cur]->stats;
+        st.critical = true;
+        criticalMs_ += st.endMs - st.startMs;
+        int prev = -1;
+        for (int d : nodes_[cur]->deps)
+            if (prev < 0 || nodes_[d]->stats.endMs > nodes_[prev]->stats.endMs) prev = d;
+        cur = prev;
+    }
+}
+
+std::string TaskGraph::describe() const {
+    std::string out;
+    auto sep = [&] { if (!out.empty()) out += "; "; };
+    for (const auto& node : nodes_) {
+        if (node->deps.empty()) {
+            if (!node->succ.empty()) continue;  // aparece como dependencia de otra
+            sep();
+            out += node->name;
+            continue;
+        }
+        sep();
+        for (std::size_t k = 0; k < node->deps.size(); ++k) {
+            if (k) out += ", ";
+            out += nodes_[node->deps[k]]->name;
+        }
+        out += " -> ";
+        out += node->name;
+    }
+    return out;
+}
@@ -6,13 +6,212 @@
 #include <algorithm>
 #include <numeric>
 #include <iostream>
+#include <chrono>
 
 #ifdef _OPENMP
   #include <omp.h>
 #endif
 
 // -------------------- util --------------------
-static float frand(float a, float b) { return a + (b - a) * (float(std::rand()) / float(RAND_MAX)); }
+// Particulas por bloque de kernel SIMD (multiplo de 16: bloques alineados)
+static constexpr int kSimdBlock = 1024;
+
+// --taskgraph: elementos por subtarea (particulas: multiplo de kSimdBlock)
+static constexpr std::size_t kGraphParticleGrain = 4 * kSimdBlock;
+static constexpr std::size_t kGraphColumnGrain   = 64;
+static constexpr std::size_t kGraphDotGrain      = 256;
+
+// Politica de grano: coste de abrir y cerrar un despacho (fork + join con
+// 8-16 hilos) y coste medio por elemento de cada sitio, medido con
+// --dump-grain y --backend serial (item_ns). Un sitio se reparte en partes de
+// al menos kForkNs / coste elementos: asi cada parte trabaja mas de lo que
+// cuesta despertarla y las de pocas decenas de elementos no salen del llamador.
+static constexpr double kForkNs = 20000.0;
+static constexpr double kSiteItemNs[int(ParSite::Count)] = {
+    /* RainCols  */ 5.0,    // columna o punto (un despacho por frame)
+    /* DashMove  */ 5.0,
+    /* DashDots  */ 5.0,
+    /* Particles */ 25.0,   // Bounce; Spiral/Nebula segun kernel (ver ctor)
+    /* GridBuild */ 15.0,   // conteo + dispersion por particula
+    /* Collide   */ 130.0,  // por celda (~2 glifos por celda, 3x3 vecinas)
+    /* RainFill  */ 30.0,   // 6 vertices por glifo o punto (estimado: solo con ventana)
+};
+// Particulas por kernel: Spiral/Nebula escalar y SIMD (AVX2/SSE)
+static constexpr double kSpiralItemNs[2] = { 22.0, 5.0 };
+static constexpr double kNebulaItemNs[2] = { 110.0, 10.0 };
+
+// Bucles fuera de los sitios medidos (init de la lluvia y volcado a sf::Text)
+static constexpr std::size_t kInitGrain = 512;
+static constexpr std::size_t kTextGrain = 1024;
+
+// Fila CSR que contiene el elemento g (start no decreciente, start[0] = 0)
+static inline int csrRow(const std::vector<std::size_t>& start, std::size_t g) {
+    return int(std::upper_bound(start.begin(), start.end(), g) - start.begin()) - 1;
+}
+
+// Recorre el bloque plano [g0, g1) llamando f(fila, indice en la fila, g):
+// una busqueda binaria por bloque y luego avance lineal por las filas.
+template <class F>
+static inline void forCsrBlock(const std::vector<std::size_t>& start,
+                               std::size_t g0, std::size_t g1, F&& f) {
+    int k = csrRow(start, g0);
+    for (std::size_t g = g0; g < g1; ++g) {
+        while (g >= start[k + 1]) ++k;
+        f(k, int(g - start[k]), g);
+    }
+}
+
+// Tiempo de CPU del hilo donde existe: no cuenta el tiempo en que el SO lo
+// desaloja, asi el desbalance refleja el trabajo y no la sobresuscripcion.
+static inline double busySeconds() {
+#if defined(CLOCK_THREAD_CPUTIME_ID)
+    timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return double(ts.tv_sec) + 1e-9 * double(ts.tv_nsec);
+#elif defined(_OPENMP)
+    return omp_get_wtime();
+#else
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static inline double wallNow() {
+#ifdef _OPENMP
+    return omp_get_wtime();
+#else
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Cada parte anota su tiempo de CPU y cuando termina (antes de que el despacho
+// espere a las demas); la espera es la diferencia hasta la vuelta del despacho.
+// Si un hilo ejecuta varias partes, la espera de las primeras incluye las siguientes.
+int TextRender::runSite(ParSite s, int parts, const ParallelBackend::PartFn& f) {
+    std::vector<double>& busy  = siteBusyMs_[int(s)];
+    std::vector<double>& wait  = siteWaitMs_[int(s)];
+    std::vector<double>& leave = siteLeave_[int(s)];
+    const int slots = std::min(parts, (int)busy.size());
+    const int team = siteBackend(s).run(parts, [&](int p) {
+        const double c0 = busySeconds();
+        f(p);
+        if (p < slots) {
+            busy[p] += (busySeconds() - c0) * 1e3;
+            leave[p] = wallNow();
+        }
+    });
+    const double tJoin = wallNow();
+    for (int p = 0; p < slots; ++p) wait[p] += (tJoin - leave[p]) * 1e3;
+    return team;
+}
+
+// SpatialGrid::build hace tres despachos: con este backend cuentan como el
+// sitio GridBuild (tiempos sumados)
+class TextRender::SiteBackend final : public ParallelBackend {
+public:
+    SiteBackend(TextRender& r, ParSite s) : r_(r), s_(s) {}
+    Backend kind() const override { return r_.par_->kind(); }
+    int threads() const override { return r_.par_->threads(); }
+    int run(int parts, const PartFn& f) override { return r_.runSite(s_, parts, f); }
+    int pin(const std::vector<int>& cpus) override { return r_.par_->pin(cpus); }
+
+private:
+    TextRender& r_;
+    ParSite s_;
+};
+
+// Cada parte anota cuando empieza y cuando termina (antes de que el despacho
+// espere a las demas); el hilo llamador mide antes y despues del despacho.
+template <class Body>
+void TextRender::parallelRegion(ParSite site, std::size_t n, Body&& body) {
+    const int parts = beginSite(site, n);
+    const double tFork = wallNow();
+    const int team = runSite(site, parts, [&](int p) {
+        if (p < (int)fjEnter_.size()) fjEnter_[p] = wallNow();
+        body(p, parts);
+    });
+    const double tJoin = wallNow();
+    endSite(site, team, (tJoin - tFork) * 1e3);
+    const std::vector<double>& leave = siteLeave_[int(site)];
+    double lastIn = tFork, lastOut = tFork;
+    for (int t = 0; t < std::min(parts, (int)fjEnter_.size()); ++t) {
+        lastIn  = std::max(lastIn, fjEnter_[t]);
+        lastOut = std::max(lastOut, leave[t]);
+    }
+    forkJoinMs_ += ((lastIn - tFork) + (tJoin - lastOut)) * 1e3;
+}
+
+template <class F>
+void TextRender::forParticles(std::size_t n, F&& f) {
+    const int parts = par_->partsFor(n, siteGrain(ParSite::Particles));
+    par_->run(parts, [&](int p) {
+        std::size_t b, e;
+        particleRange(n, p, parts, b, e);
+        if (b < e) f(b, e);
+    });
+}
+
+void TextRender::particleRange(std::size_t n, int p, int parts, std::size_t& b, std::size_t& e) const {
+    const bool blocks = (mode_ == MotionMode::Spiral && simd_.spiral)
+                     || (mode_ == MotionMode::Nebula && simd_.nebula);
+    if (!blocks) { partRange(n, p, parts, b, e); return; }
+    // Por bloques enteros: cada parte arranca alineada
+    std::size_t bb, be;
+    partRange((n + kSimdBlock - 1) / kSimdBlock, p, parts, bb, be);
+    b = std::min(n, bb * kSimdBlock);
+    e = std::min(n, be * kSimdBlock);
+}
+
+// Fija el equipo de par (y pool si par no lo usa) a cpus rotada desde first
+static int pinBackend(const std::vector<int>& list, int first, ParallelBackend& par, WorkPool* pool) {
+    if (list.empty()) return 0;
+    std::vector<int> cpus = list;
+    std::rotate(cpus.begin(), cpus.begin() + first % int(cpus.size()), cpus.end());
+    const int pinned = par.pin(cpus);
+    if (pool && par.kind() != Backend::Pool) pool->pin(cpus);
+    return pinned;
+}
+
+int TextRender::pinThreads(int first) {
+    return pinBackend(cfg_.pinCpus, first, *par_, pool_.get());
+}
+
+ParallelBackend& TextRender::siteBackend(ParSite s) {
+    return (s == ParSite::RainFill && renderPar_) ? *renderPar_ : *par_;
+}
+
+int TextRender::beginSite(ParSite s, std::size_t n) {
+    SiteRun& r = siteRun_[int(s)];
+    r.trip = n;
+    r.parts = siteBackend(s).partsFor(n, siteGrain(s));
+    std::fill(siteBusyMs_[int(s)].begin(), siteBusyMs_[int(s)].end(), 0.0);
+    std::fill(siteWaitMs_[int(s)].begin(), siteWaitMs_[int(s)].end(), 0.0);
+    return r.parts;
+}
+
+void TextRender::endSite(ParSite s, int team, double wallMs) {
+    siteThreads_[int(s)] = team;
+    SiteRun& r = siteRun_[int(s)];
+    r.wallMs = wallMs;
+    ++r.runs;
+}
+
+std::size_t TextRender::siteGrain(ParSite s) const {
+    return std::max<std::size_t>(1, std::size_t(kForkNs / siteItemNs_[int(s)]));
+}
+
+const char* parSiteName(ParSite s) {
+    switch (s) {
+        case ParSite::RainCols:   return "rain_cols";
+        case ParSite::DashMove:   return "dash_move";
+        case ParSite::DashDots:   return "dash_dots";
+        case ParSite::Particles:  return "particles";
+        case ParSite::GridBuild:  return "grid_build";
+        case ParSite::Collide:    return "collide";
+        case ParSite::RainFill:   return "rain_fill";
+        case ParSite::Count:      break;
+    }
+    return "unknown";
+}
 
 // -------------------- ctor --------------------
 TextRender::TextRender(int N,
@@ -21,127 +220,488 @@ TextRender::TextRender(int N,
                        sf::Vector2u windowSize,
                        MotionMode mode,
                        float speed,
-                       Palette palette)
+                       Palette palette,
+                       const RenderConfig& cfg)
     : size_(windowSize),
       mode_(mode),
       speed_(speed),
       charSize_(charSize),
-      palette_(palette)
+      palette_(palette),
+      cfg_(cfg)
 {
-    std::srand(unsigned(std::time(nullptr)));
+    simd_ = resolveSimdKernels(cfg_.kernel);
+    std::copy(std::begin(kSiteItemNs), std::end(kSiteItemNs), siteItemNs_.begin());
+    if (mode_ == MotionMode::Spiral)
+        siteItemNs_[int(ParSite::Particles)] = kSpiralItemNs[simd_.spiral ? 1 : 0];
+    else if (mode_ == MotionMode::Nebula)
+        siteItemNs_[int(ParSite::Particles)] = kNebulaItemNs[simd_.nebula ? 1 : 0];
+    if (cfg_.taskGraph || cfg_.backend == Backend::Pool) {
+#ifdef _OPENMP
+        pool_ = std::make_unique<WorkPool>(omp_get_max_threads());
+#else
+        pool_ = std::make_unique<WorkPool>(int(std::thread::hardware_concurrency()));
+#endif
+    }
+    par_ = makeParallelBackend(cfg_.backend, pool_.get());
+    if (cfg_.pipelined) {
+        // render y update corren a la vez desde hilos distintos: el render
+        // lleva su propio backend (y pool) para no mezclar trabajos ni
+        // metricas. Aqui solo se fija el del render; el de update lo fija el
+        // hilo de --pipeline al arrancar (pinThreads(1))
+        if (pool_ && cfg_.backend == Backend::Pool)
+            renderPool_ = std::make_unique<WorkPool>(pool_->size());
+        renderPar_ = makeParallelBackend(cfg_.backend, renderPool_.get());
+        pinned_ = pinBackend(cfg_.pinCpus, 0, *renderPar_, renderPool_.get());
+    } else {
+        pinned_ = pinThreads();
+    }
+    const int maxThreads = std::max(1, par_->threads());
+    for (auto& v : siteBusyMs_) v.assign(maxThreads, 0.0);
+    for (auto& v : siteWaitMs_) v.assign(maxThreads, 0.0);
+    for (auto& v : siteLeave_) v.assign(maxThreads, 0.0);
+    fjEnter_.assign(maxThreads, 0.0);
+    initGlyphMetrics(font);
 
     if (mode_ == MotionMode::Rain) {
         initRain(std::max(1, N), font);
         int dashCount = std::clamp(int(std::round(std::sqrt(float(std::max(1, N))) / 3.f)), 4, 7);
         initDashes(font, dashCount);
+        layoutRainBatch();
     } else if (mode_ == MotionMode::Nebula) {
         initNebula(std::max(1, N), font);
 
         // OBJ centrado en pantalla
+        const auto tObj = std::chrono::steady_clock::now();
         model_ = std::make_unique<ObjModel>();
         modelEnabled_ = model_->loadFromOBJ("assets/models/center.obj");
+        objLoadMs_ = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tObj).count();
         if (!modelEnabled_) {
             std::cerr << "[OBJ] No se pudo cargar assets/models/center.obj\n";
         }
 
         // Estado inicial: o rota, o deriva en diagonal
-        if (std::rand() % 2 == 0) {
+        CounterRng rng = modelRng();
+        if (!rng.coin()) {
             modelCtrl_.mode = ModelCtrl::Mode::RotateY;
-            modelCtrl_.yawVelDeg = frand(40.f, 120.f) * ((std::rand()%2)? 1.f : -1.f);
-            modelCtrl_.timer = frand(2.5f, 5.0f);
+            modelCtrl_.yawVelDeg = rng.uniform(40.f, 120.f) * rng.sign();
+            modelCtrl_.timer = rng.uniform(2.5f, 5.0f);
         } else {
             modelCtrl_.mode = ModelCtrl::Mode::Drift;
-            float speedPix = frand(60.f, 160.f);
-            float sx = (std::rand()%2 ? 1.f : -1.f);
-            float sy = (std::rand()%2 ? 1.f : -1.f);
+            float speedPix = rng.uniform(60.f, 160.f);
+            float sx = rng.sign();
+            float sy = rng.sign();
             float inv = 1.0f / std::sqrt(2.f);
             modelCtrl_.driftVel = { sx * speedPix * inv, sy * speedPix * inv };
-            modelCtrl_.timer = frand(2.0f, 4.0f);
+            modelCtrl_.timer = rng.uniform(2.0f, 4.0f);
         }
         modelCtrl_.offset = {0.f, 0.f};
         modelCtrl_.returning = false;
 
     } else {
         initParticles(std::max(1, N), font);
+        // Radio de choque ~ caja del glifo, acotado para que los discos cubran a lo
+        // sumo la mitad de la pantalla: con mas densidad no caben sin solaparse y
+        // la ocupacion por celda (celda = diametro, vecinos en 3x3) dejaria de ser O(1).
+        const sf::FloatRect b = glyphBox('0', float(charSize_));
+        const float rFit = std::sqrt(0.5f * float(size_.x) * float(size_.y)
+                                     / (3.14159265f * float(std::max(1, N))));
+        collideR_ = std::min(0.5f * std::max(b.width, b.height), rFit);
+    }
+
+    modelCtrl_.prevYawDeg = modelCtrl_.yawDeg;
+    modelCtrl_.prevOffset = modelCtrl_.offset;
+
+    if (cfg_.taskGraph) buildGraph();
+
+    // Pipeline: las dos vistas parten iguales (color/caracter solo se fijan aqui)
+    if (cfg_.pipelined) {
+        pvFront_.resize(pv_.size());
+        forParticles(pv_.size(), [&](std::size_t b, std::size_t e) { pvFront_.copyRange(pv_, b, e); });
+        publishScene();
     }
 }
 
 // -------------------- helpers --------------------
-sf::Color TextRender::generatePseudoRandomColor(int seed) {
-    std::mt19937 rng(seed);
-    std::uniform_int_distribution<int> colorChannel(50, 255);
-    return sf::Color(colorChannel(rng), colorChannel(rng), colorChannel(rng));
+sf::Color TextRender::generatePseudoRandomColor(int index) {
+    CounterRng rng(cfg_.seed, RngDomain::Color, std::uint64_t(index));
+    const auto channel = [&] { return sf::Uint8(50 + rng.below(206)); };
+    const sf::Uint8 r = channel(), g = channel(), b = channel();
+    return sf::Color(r, g, b);
+}
+
+// Flujo para el siguiente cambio de estado del modelo (update es serial aqui)
+CounterRng TextRender::modelRng() {
+    return CounterRng(cfg_.seed, RngDomain::Model, modelEvents_++);
+}
+
+// FNV-1a sobre los bytes de cada arreglo de estado (float/int exactos)
+static void hashBytes(std::uint64_t& h, const void* p, std::size_t n) {
+    const unsigned char* b = static_cast<const unsigned char*>(p);
+    for (std::size_t i = 0; i < n; ++i) { h ^= b[i]; h *= 0x100000001B3ull; }
+}
+
+std::uint64_t TextRender::stateHash() const {
+    // Con pipeline el ultimo paso puede estar en la vista publicada
+    const ParticleView& pv = latestView();
+    std::uint64_t h = 0xCBF29CE484222325ull;
+    for (const AlignedVec<float>* a : { &ps_.posX, &ps_.posY, &ps_.velX, &ps_.velY, &ps_.baseSize,
+                                        &ps_.angle, &ps_.angVel, &ps_.baseRadius, &ps_.radiusAmp,
+                                        &ps_.z, &ps_.zVel, &ps_.phase,
+                                        &ps_.spinDeg, &ps_.spinVelDeg, &ps_.scale, &ps_.scaleVel,
+                                        &ps_.alpha, &ps_.alphaVel, &ps_.noiseSeed,
+                                        &pv.x, &pv.y, &pv.rot, &pv.scale, &pv.charSize })
+        hashBytes(h, a->data(), a->size() * sizeof(float));
+    hashBytes(h, pv.rgba.data(), pv.rgba.size() * sizeof(std::uint32_t));
+    hashBytes(h, pv.ch.data(), pv.ch.size());
+    for (std::size_t k = 0; k < drops.size(); ++k) {
+        hashBytes(h, &rainHeadY_[k], sizeof(float));
+        hashBytes(h, &rainFlick_[k], sizeof(int));
+    }
+    hashBytes(h, rainCodes_.data(), rainCodes_.size());
+    for (const DashLine& L : dashes) {
+        hashBytes(h, &L.xLeft, sizeof L.xLeft);
+        hashBytes(h, &L.vx, sizeof L.vx);
+    }
+    hashBytes(h, &modelCtrl_.yawDeg, sizeof modelCtrl_.yawDeg);
+    hashBytes(h, &modelCtrl_.offset, sizeof modelCtrl_.offset);
+    return h;
+}
+
+// -------------------- metricas de glifo --------------------
+void TextRender::initGlyphMetrics(const sf::Font& font) {
+    font_ = &font;
+    for (int c = 32; c < 127; ++c) {
+        if (cfg_.headless) {
+            // Estimacion monoespaciada: suficiente para rebotes/origen/espaciado
+            const float s = float(charSize_);
+            glyphBox_[c] = { s * 0.05f, s * 0.30f, s * 0.55f, s * 0.70f };
+        } else {
+            // Igual que sf::Text::getLocalBounds para un solo caracter
+            // (tambien precarga la pagina de textura: el render por lotes solo lee)
+            const sf::Glyph& g = font.getGlyph(sf::Uint32(c), charSize_, false);
+            glyphs_[c] = g;
+            glyphBox_[c] = { g.bounds.left, float(charSize_) + g.bounds.top,
+                             g.bounds.width, g.bounds.height };
+        }
+    }
+}
+
+sf::FloatRect TextRender::glyphBox(char ch, float size) const {
+    const sf::FloatRect& b = glyphBox_[(unsigned char)ch & 127u];
+    const float k = size / float(charSize_);
+    return { b.left * k, b.top * k, b.width * k, b.height * k };
 }
 
 // -------------------- update/render/resize --------------------
 void TextRender::update(float dt) {
     time_ += dt;
-    if (mode_ == MotionMode::Rain) {
-        updateRain(dt);
-        updateDashes(dt);
+    forkJoinMs_ = 0.0;
+    if (cfg_.taskGraph) {
+        graphDt_ = dt;
+        graph_.run(*pool_);
+    } else if (mode_ == MotionMode::Rain) {
+        // Un solo despacho por frame: las lineas (pocas) se mueven antes en el
+        // hilo llamador, asi columnas y puntos no necesitan barrera entre si
+        moveDashLines(dt);
+        parallelRegion(ParSite::RainCols, drops.size() + dashDotX_.size(), [&](int p, int parts) {
+            rainColumns(p, parts, dt);
+            dashDotsPart(p, parts);
+        });
     } else if (mode_ == MotionMode::Bounce) {
-        #pragma omp parallel for schedule(static)
-        for (auto& p : ps) updateBounce(p, dt);
+        const int n = (int)activeN_;
+        const bool interp = cfg_.interpolate;
+        if (cfg_.collisions) collideBounce();
+        parallelRegion(ParSite::Particles, std::size_t(n), [&](int p, int parts) {
+            std::size_t b, e;
+            particleRange(std::size_t(n), p, parts, b, e);
+            if (interp) savePrevPositions(b, e);
+            for (std::size_t i = b; i < e; ++i) updateBounce(i, dt);
+        });
     } else if (mode_ == MotionMode::Spiral) {
-        #pragma omp parallel for schedule(static)
-        for (auto& p : ps) updateSpiral(p, dt);
+        const int n = (int)activeN_;
+        const bool interp = cfg_.interpolate;
+        if (simd_.spiral) {
+            const SpiralKernelArgs args{
+                ps_.angle.data(), ps_.angVel.data(),
+                ps_.baseRadius.data(), ps_.radiusAmp.data(), ps_.phase.data(),
+                ps_.z.data(), ps_.zVel.data(), ps_.baseSize.data(),
+                pv_.x.data(), pv_.y.data(), pv_.charSize.data(), pv_.rgba.data(),
+                size_.x * 0.5f, size_.y * 0.5f, dt };
+            parallelRegion(ParSite::Particles, std::size_t(n), [&](int p, int parts) {
+                std::size_t b0, b1;
+                particleRange(std::size_t(n), p, parts, b0, b1);
+                if (b0 >= b1) return;
+                if (interp) savePrevPositions(b0, b1);
+                simd_.spiral(args, b0, b1);
+            });
+        } else {
+            parallelRegion(ParSite::Particles, std::size_t(n), [&](int p, int parts) {
+                std::size_t b, e;
+                particleRange(std::size_t(n), p, parts, b, e);
+                if (interp) savePrevPositions(b, e);
+                for (std::size_t i = b; i < e; ++i) updateSpiral(i, dt);
+            });
+        }
     } else { // Nebula
-        #pragma omp parallel for schedule(static)
-        for (auto& p : ps) updateNebula(p, dt);
+        const int n = (int)activeN_;
+        const bool interp = cfg_.interpolate;
+        if (simd_.nebula) {
+            const NebulaKernelArgs args{
+                ps_.posX.data(), ps_.posY.data(), ps_.velX.data(), ps_.velY.data(),
+                ps_.spinDeg.data(), ps_.spinVelDeg.data(),
+                ps_.scale.data(), ps_.scaleVel.data(),
+                ps_.alpha.data(), ps_.alphaVel.data(), ps_.noiseSeed.data(),
+                pv_.x.data(), pv_.y.data(), pv_.rot.data(), pv_.scale.data(), pv_.rgba.data(),
+                time_, dt, std::max(40.f, speed_) * 0.5f };
+            parallelRegion(ParSite::Particles, std::size_t(n), [&](int p, int parts) {
+                std::size_t b0, b1;
+                particleRange(std::size_t(n), p, parts, b0, b1);
+                if (b0 >= b1) return;
+                if (interp) savePrevPositions(b0, b1);
+                simd_.nebula(args, b0, b1);
+            });
+        } else {
+            parallelRegion(ParSite::Particles, std::size_t(n), [&](int p, int parts) {
+                std::size_t b, e;
+                particleRange(std::size_t(n), p, parts, b, e);
+                if (interp) savePrevPositions(b, e);
+                for (std::size_t i = b; i < e; ++i) updateNebula(i, dt);
+            });
+        }
         updateModel(dt);
     }
+    backFresh_ = true;
+}
+
+// Interpolacion: la posicion del ultimo paso pasa a ser la previa del
+// siguiente (cada hilo copia el mismo tramo que luego actualiza)
+void TextRender::savePrevPositions(std::size_t b, std::size_t e) {
+    const ParticleView& last = latestView();
+    for (std::size_t i = b; i < e; ++i) {
+        pv_.prevX[i] = last.x[i];
+        pv_.prevY[i] = last.y[i];
+    }
 }
 
-void TextRender::render(sf::RenderWindow& window) {
+void TextRender::render(sf::RenderWindow& window, float alpha) {
+    FrameView v = frameView();
+    if (cfg_.interpolate) interpolateScene(v, std::clamp(alpha, 0.f, 1.f));
     if (mode_ == MotionMode::Rain) {
-        for (auto& d : drops)
-            for (auto& g : d.glyphs) window.draw(g);
-        for (auto& L : dashes)
-            for (auto& dot : L.dots) window.draw(dot);
+        if (cfg_.batchRain && !cfg_.headless) { renderRainBatched(window, v); return; }
+        // Ruta de comparacion: mismos glifos derivados, un draw por sf::Text
+        renderBackend().forStatic(rainText_.empty() ? 0 : rainActiveStart_.back(), [&](std::size_t b, std::size_t e) {
+            forCsrBlock(rainActiveStart_, b, e, [&](int a, int i, std::size_t) {
+                const int k = rainActive_[a];
+                const RainGlyph r = rainGlyph(v, k, i);
+                sf::Text& t = rainText_[rainStart_[k] + i];
+                t.setString(sf::String(sf::Uint32((unsigned char)r.ch)));
+                t.setFillColor(r.color);
+                t.setPosition(drops[k].x, r.y);
+            });
+        }, kTextGrain);
+        if (!rainText_.empty())
+            for (int k : rainActive_)
+                for (std::size_t g = rainStart_[k]; g < rainStart_[k + 1]; ++g) window.draw(rainText_[g]);
+        for (std::size_t li = 0; li < dashes.size(); ++li) {
+            for (std::size_t d = dashStart_[li]; d < dashStart_[li + 1]; ++d) {
+                dashDots_[d].setPosition(v.dotX[d], dashes[li].y);
+                window.draw(dashDots_[d]);
+            }
+        }
     } else if (mode_ == MotionMode::Nebula) {
-    for (auto& p : ps) window.draw(p.text);
+    syncParticleTexts(v);
+    for (std::size_t i = 0; i < std::min(activeN_, psText_.size()); ++i) window.draw(psText_[i]);
     if (modelEnabled_ && model_) {
         // centro desplazado por el offset animado
         sf::Vector2f centerPx(
-            float(size_.x) * 0.5f + modelCtrl_.offset.x,
-            float(size_.y) * 0.5f + modelCtrl_.offset.y
+            float(size_.x) * 0.5f + v.offset.x,
+            float(size_.y) * 0.5f + v.offset.y
         );
 
         // escala del modelo
         float scalePx = 0.40f * std::min(float(size_.x), float(size_.y));
 
         // convertir grados -> radianes
-        float angleRad = modelCtrl_.yawDeg * 0.01745329252f; // pi/180
+        float angleRad = v.yawDeg * 0.01745329252f; // pi/180
 
         // NUEVA llamada (reemplaza a drawProjectedYawAndOffset)
         model_->drawProjected(window, centerPx, scalePx, angleRad,
                               sf::Color(220, 220, 220, 235));
     }
     } else {
-        for (auto& p : ps) window.draw(p.text);
+        syncParticleTexts(v);
+        for (std::size_t i = 0; i < std::min(activeN_, psText_.size()); ++i) window.draw(psText_[i]);
     }
 }
 
+// Vuelca la vista SoA en los sf::Text (cada hilo toca objetos distintos)
+void TextRender::syncParticleTexts(const FrameView& v) {
+    const bool nebula = (mode_ == MotionMode::Nebula);
+    const ParticleView& pv = *v.pv;
+    const float a = v.alpha;
+    renderBackend().forStatic(std::min(activeN_, psText_.size()), [&](std::size_t b, std::size_t e) {
+        for (std::size_t i = b; i < e; ++i) {
+            sf::Text& t = psText_[i];
+            t.setFillColor(sf::Color(pv.rgba[i]));
+            if (nebula) {
+                t.setRotation(pv.rot[i]);
+                t.setScale(pv.scale[i], pv.scale[i]);
+            } else {
+                t.setCharacterSize(unsigned(pv.charSize[i]));
+            }
+            if (a < 1.f) t.setPosition(pv.prevX[i] + (pv.x[i] - pv.prevX[i]) * a,
+                                       pv.prevY[i] + (pv.y[i] - pv.prevY[i]) * a);
+            else         t.setPosition(pv.x[i], pv.y[i]);
+        }
+    }, kTextGrain);
+}
+
 void TextRender::resize(sf::Vector2u newSize) {
     size_ = newSize;
     if (mode_ == MotionMode::Rain) {
-        const sf::Font* f = nullptr;
-        if (!drops.empty() && !drops[0].glyphs.empty()) f = drops[0].glyphs[0].getFont();
-        if (!f && !dashes.empty() && !dashes[0].dots.empty()) f = dashes[0].dots[0].getFont();
-        if (f) {
-            int totalGlyphs = 0;
-            #pragma omp parallel for reduction(+:totalGlyphs) schedule(static)
-            for (int k = 0; k < (int)drops.size(); ++k) totalGlyphs += (int)drops[k].glyphs.size();
-            initRain(totalGlyphs, *f);
-            initDashes(*f, std::max(4, (int)dashes.size()));
+        if (font_) {
+            initRain(int(rainCodes_.size()), *font_);
+            initDashes(*font_, std::max(4, (int)dashes.size()));
+            layoutRainBatch();
+            if (cfg_.taskGraph) buildGraph();
+            if (cfg_.pipelined) publishScene();
         }
     }
 }
 
+// -------------------- pipeline update/render --------------------
+TextRender::FrameView TextRender::frameView() const {
+    if (cfg_.pipelined)
+        return { &pvFront_, published_.headY.data(), published_.flick.data(),
+                 published_.dotX.data(), published_.time, published_.yawDeg,
+                 published_.offset, 1.f };
+    return { &pv_, rainHeadY_.data(), rainFlick_.data(), dashDotX_.data(),
+             time_, modelCtrl_.yawDeg, modelCtrl_.offset, 1.f };
+}
+
+// Mezcla el penultimo y el ultimo paso en la vista (live o publicada).
+// Particulas: se mezclan al volcar los sf::Text (v.alpha).
+void TextRender::interpolateScene(FrameView& v, float alpha) {
+    const bool pub = cfg_.pipelined;
+    const std::vector<float>& prevHead = pub ? published_.prevHeadY  : rainPrevHeadY_;
+    const std::vector<float>& prevDot  = pub ? published_.prevDotX   : dashPrevDotX_;
+    const float prevYaw                = pub ? published_.prevYawDeg : modelCtrl_.prevYawDeg;
+    const sf::Vector2f prevOff         = pub ? published_.prevOffset : modelCtrl_.prevOffset;
+
+    // Una cabeza que dio la vuelta en el ultimo paso se dibuja sin mezclar
+    // (la mezcla la llevaria hacia atras por toda la pantalla)
+    lerpHeadY_.resize(prevHead.size());
+    for (std::size_t k = 0; k < prevHead.size(); ++k) {
+        const float h0 = prevHead[k], h1 = v.headY[k];
+        lerpHeadY_[k] = (h1 >= h0) ? h0 + (h1 - h0) * alpha : h1;
+    }
+    lerpDotX_.resize(prevDot.size());
+    for (std::size_t d = 0; d < prevDot.size(); ++d)
+        lerpDotX_[d] = prevDot[d] + (v.dotX[d] - prevDot[d]) * alpha;
+
+    v.headY  = lerpHeadY_.data();
+    v.dotX   = lerpDotX_.data();
+    v.yawDeg = prevYaw + (v.yawDeg - prevYaw) * alpha;
+    v.offset = prevOff + (v.offset - prevOff) * alpha;
+    v.alpha  = alpha;
+}
+
+// Particulas: intercambio de vistas (update reescribe cada frame todo lo que
+// cambia; color y caracter son iguales en las dos). Lluvia, lineas y modelo
+// son O(columnas): se copian.
+void TextRender::publishFrame() {
+    if (!cfg_.pipelined || !backFresh_) return;  // frame sin pasos: nada nuevo
+    std::swap(pv_, pvFront_);
+    backFresh_ = false;
+    publishScene();
+}
+
+void TextRender::publishScene() {
+    published_.headY      = rainHeadY_;
+    published_.prevHeadY  = rainPrevHeadY_;
+    published_.flick      = rainFlick_;
+    published_.dotX       = dashDotX_;
+    published_.prevDotX   = dashPrevDotX_;
+    published_.time       = time_;
+    published_.yawDeg     = modelCtrl_.yawDeg;
+    published_.prevYawDeg = modelCtrl_.prevYawDeg;
+    published_.offset     = modelCtrl_.offset;
+    published_.prevOffset = modelCtrl_.prevOffset;
+}
+
+// -------------------- grafo de tareas (--taskgraph) --------------------
+// Una tarea por subsistema; los bucles grandes se parten en subtareas que el
+// pool reparte con robo de trabajo. Rain: columnas y lineas en paralelo (los
+// puntos dependen de las lineas). Nebula: particulas y modelo en paralelo.
+void TextRender::buildGraph() {
+    graph_.clear();
+    if (mode_ == MotionMode::Rain) {
+        graph_.add("rain_cols", [this](std::size_t b, std::size_t e) {
+            advanceRainColumns(b, e, graphDt_);
+        }, {}, drops.size(), kGraphColumnGrain);
+        const int move = graph_.add("dash_move", [this](std::size_t b, std::size_t e) {
+            for (std::size_t li = b; li < e; ++li) moveDashLine(int(li), graphDt_);
+        }, {}, dashes.size(), dashes.size());
+        graph_.add("dash_dots", [this](std::size_t b, std::size_t e) {
+            placeDashDots(b, e);
+        }, { move }, dashDotX_.size(), kGraphDotGrain);
+        return;
+    }
+
+    const std::size_t n = activeN_;
+    std::vector<int> deps;
+    if (mode_ == MotionMode::Bounce && cfg_.collisions) {
+        // Rejilla + fase estrecha: su propio despacho desde el hilo del pool
+        // (con --backend pool queda anidado en el mismo pool)
+        deps.push_back(graph_.add("collide", [this](std::size_t, std::size_t) {
+#ifdef _OPENMP
+            omp_set_num_threads(pool_->size());  // ICV por hilo: la del pool no la hereda
+#endif
+            collideBounce();
+        }));
+    }
+    const bool interp = cfg_.interpolate;
+    graph_.add("particles", [this, interp](std::size_t b, std::size_t e) {
+        if (interp) savePrevPositions(b, e);
+        const float dt = graphDt_;
+        if (mode_ == MotionMode::Bounce) {
+            for (std::size_t i = b; i < e; ++i) updateBounce(i, dt);
+        } else if (mode_ == MotionMode::Spiral) {
+            if (simd_.spiral) {
+                const SpiralKernelArgs args{
+                    ps_.angle.data(), ps_.angVel.data(),
+                    ps_.baseRadius.data(), ps_.radiusAmp.data(), ps_.phase.data(),
+                    ps_.z.data(), ps_.zVel.data(), ps_.baseSize.data(),
+                    pv_.x.data(), pv_.y.data(), pv_.charSize.data(), pv_.rgba.data(),
+                    size_.x * 0.5f, size_.y * 0.5f, dt };
+                simd_.spiral(args, b, e);
+            } else {
+                for (std::size_t i = b; i < e; ++i) updateSpiral(i, dt);
+            }
+        } else if (simd_.nebula) {
+            const NebulaKernelArgs args{
+                ps_.posX.data(), ps_.posY.data(), ps_.velX.data(), ps_.velY.data(),
+                ps_.spinDeg.data(), ps_.spinVelDeg.data(),
+                ps_.scale.data(), ps_.scaleVel.data(),
+                ps_.alpha.data(), ps_.alphaVel.data(), ps_.noiseSeed.data(),
+                pv_.x.data(), pv_.y.data(), pv_.rot.data(), pv_.scale.data(), pv_.rgba.data(),
+                time_, dt, std::max(40.f, speed_) * 0.5f };
+            simd_.nebula(args, b, e);
+        } else {
+            for (std::size_t i = b; i < e; ++i) updateNebula(i, dt);
+        }
+    }, deps, n, kGraphParticleGrain);
+
+    if (mode_ == MotionMode::Nebula)
+        graph_.add("model", [this](std::size_t, std::size_t) { updateModel(graphDt_); });
+}
+
 // -------------------- control del modelo (Nebula) --------------------
 void TextRender::updateModel(float dt) {
     if (!modelEnabled_ || !model_) return;
 
+    modelCtrl_.prevYawDeg = modelCtrl_.yawDeg;
+    modelCtrl_.prevOffset = modelCtrl_.offset;
     modelCtrl_.timer -= dt;
 
     if (modelCtrl_.mode == ModelCtrl::Mode::RotateY) {
@@ -154,13 +714,14 @@ void TextRender::updateModel(float dt) {
 
         if (modelCtrl_.timer <= 0.f) {
             // Cambiar a drift
+            CounterRng rng = modelRng();
             modelCtrl_.mode = ModelCtrl::Mode::Drift;
-            float speedPix = frand(60.f, 160.f);
-            float sx = (std::rand()%2 ? 1.f : -1.f);
-            float sy = (std::rand()%2 ? 1.f : -1.f);
+            float speedPix = rng.uniform(60.f, 160.f);
+            float sx = rng.sign();
+            float sy = rng.sign();
             float inv = 1.0f / std::sqrt(2.f);
             modelCtrl_.driftVel = { sx * speedPix * inv, sy * speedPix * inv };
-            modelCtrl_.timer = frand(2.0f, 4.0f);
+            modelCtrl_.timer = rng.uniform(2.0f, 4.0f);
             modelCtrl_.returning = false;
         }
     } else { // Drift
@@ -180,100 +741,150 @@ void TextRender::updateModel(float dt) {
             if (std::abs(modelCtrl_.offset.x) < 2.f && std::abs(modelCtrl_.offset.y) < 2.f) {
                 modelCtrl_.offset = {0.f, 0.f};
                 modelCtrl_.returning = false;
+                CounterRng rng = modelRng();
                 modelCtrl_.mode = ModelCtrl::Mode::RotateY;
-                modelCtrl_.yawVelDeg = frand(40.f, 120.f) * ((std::rand()%2)? 1.f : -1.f);
-                modelCtrl_.timer = frand(2.5f, 5.0f);
+                modelCtrl_.yawVelDeg = rng.uniform(40.f, 120.f) * rng.sign();
+                modelCtrl_.timer = rng.uniform(2.5f, 5.0f);
             }
         }
     }
 }
 
 // -------------------- init partículas (Bounce/Spiral) --------------------
+// Init en paralelo: cada particula tiene su flujo RNG (mismo resultado con
+// cualquier numero de hilos) y los arreglos ya dimensionados (sin tocar: ver
+// AlignedAllocator) se llenan por indice con el reparto de update, asi cada
+// pagina la toca primero el hilo que la actualiza. Los sf::Text solo existen
+// si habra render (no en headless).
 void TextRender::initParticles(int N, const sf::Font& font) {
-    ps.clear(); ps.reserve(N);
+    ps_.resize(N);
+    pv_.resize(N);
+    activeN_ = std::min<std::size_t>(N, std::max<long>(1, std::lround(double(detail_) * N)));
+    psText_.clear();
+    if (!cfg_.headless) psText_.resize(N);
+    const bool texts = !psText_.empty();
     const float minR = 20.f;
     const float maxR = std::min(size_.x, size_.y) * 0.48f;
 
-    for (int i = 0; i < N; ++i) {
-        Particle p{};
-        p.text.setFont(font);
-        p.text.setString((std::rand() % 2) ? "1" : "0");
-        p.baseSize = float(charSize_);
-        p.text.setCharacterSize(unsigned(p.baseSize));
-        p.text.setFillColor(generatePseudoRandomColor(i));
-
-        p.pos = { frand(0.f, float(size_.x)), frand(0.f, float(size_.y)) };
-
-        const float ang = frand(0.f, 2.f * 3.14159265f);
-        p.vel = { speed_ * std::cos(ang), speed_ * std::sin(ang) };
-
-        // Spiral
-        p.angle     = frand(0.f, 2.f * 3.14159265f);
-        p.angVel    = frand(0.6f, 1.6f) * ((std::rand() % 2) ? 1.f : -1.f);
-        p.baseRadius= frand(minR, maxR);
-        p.radiusAmp = frand(10.f, 60.f);
-        p.z         = frand(-300.f, 300.f);
-        p.zVel      = frand(-30.f, 30.f);
-        p.phase     = frand(0.f, 2.f * 3.14159265f);
-
-        // Nebula
-        p.spinDeg   = frand(0.f, 360.f);
-        p.spinVelDeg= frand(60.f, 220.f) * ((std::rand() % 2) ? 1.f : -1.f);
-        p.scale     = frand(0.8f, 1.2f);
-        p.scaleVel  = frand(-0.35f, 0.35f);
-        p.alpha     = frand(140.f, 230.f);
-        p.alphaVel  = frand(-25.f, 25.f);
-        p.noiseSeed = frand(0.f, 1000.f);
-
-        p.text.setPosition(p.pos);
-        ps.push_back(std::move(p));
-    }
+    forParticles(std::size_t(N), [&](std::size_t b, std::size_t e) {
+        for (int i = int(b); i < int(e); ++i) {
+            CounterRng rng(cfg_.seed, RngDomain::Particle, std::uint64_t(i));
+            const char ch = rng.coin() ? '1' : '0';
+            ps_.baseSize[i] = float(charSize_);
+
+            ps_.posX[i] = rng.uniform(0.f, float(size_.x));
+            ps_.posY[i] = rng.uniform(0.f, float(size_.y));
+
+            const float ang = rng.uniform(0.f, 2.f * 3.14159265f);
+            ps_.velX[i] = speed_ * std::cos(ang);
+            ps_.velY[i] = speed_ * std::sin(ang);
+
+            // Spiral
+            ps_.angle[i]      = rng.uniform(0.f, 2.f * 3.14159265f);
+            ps_.angVel[i]     = rng.uniform(0.6f, 1.6f) * rng.sign();
+            ps_.baseRadius[i] = rng.uniform(minR, maxR);
+            ps_.radiusAmp[i]  = rng.uniform(10.f, 60.f);
+            ps_.z[i]          = rng.uniform(-300.f, 300.f);
+            ps_.zVel[i]       = rng.uniform(-30.f, 30.f);
+            ps_.phase[i]      = rng.uniform(0.f, 2.f * 3.14159265f);
+
+            // Nebula
+            ps_.spinDeg[i]    = rng.uniform(0.f, 360.f);
+            ps_.spinVelDeg[i] = rng.uniform(60.f, 220.f) * rng.sign();
+            ps_.scale[i]      = rng.uniform(0.8f, 1.2f);
+            ps_.scaleVel[i]   = rng.uniform(-0.35f, 0.35f);
+            ps_.alpha[i]      = rng.uniform(140.f, 230.f);
+            ps_.alphaVel[i]   = rng.uniform(-25.f, 25.f);
+            ps_.noiseSeed[i]  = rng.uniform(0.f, 1000.f);
+
+            pv_.ch[i]       = ch;
+            pv_.rgba[i]     = generatePseudoRandomColor(i).toInteger();
+            pv_.x[i]        = ps_.posX[i];
+            pv_.y[i]        = ps_.posY[i];
+            pv_.rot[i]      = 0.f;
+            pv_.scale[i]    = 1.f;
+            pv_.charSize[i] = ps_.baseSize[i];
+            pv_.prevX[i]    = pv_.x[i];
+            pv_.prevY[i]    = pv_.y[i];
+
+            if (texts) {
+                sf::Text& t = psText_[i];
+                t.setFont(font);
+                t.setCharacterSize(charSize_);
+                t.setString(std::string(1, ch));
+                t.setFillColor(sf::Color(pv_.rgba[i]));
+                t.setPosition(pv_.x[i], pv_.y[i]);
+            }
+        }
+    });
 }
 
 // -------------------- init Nebula --------------------
 void TextRender::initNebula(int N, const sf::Font& font) {
-    ps.clear(); ps.reserve(N);
+    ps_.resize(N);
+    pv_.resize(N);
+    activeN_ = std::min<std::size_t>(N, std::max<long>(1, std::lround(double(detail_) * N)));
+    psText_.clear();
+    if (!cfg_.headless) psText_.resize(N);
+    const bool texts = !psText_.empty();
     const float densityScale = std::clamp(300.f / float(std::max(200, N)), 0.35f, 1.0f);
 
-    for (int i = 0; i < N; ++i) {
-        Particle p{};
-        p.text.setFont(font);
-        char ch = alphabet_[std::rand() % alphabet_.size()];
-        p.text.setString(std::string(1, ch));
-
-        p.baseSize = float(charSize_) * densityScale;
-        p.text.setCharacterSize(unsigned(p.baseSize));
-
-        float t01 = frand(0.f, 1.f);
-        p.text.setFillColor(nebulaColor(t01, 200.f));
-
-        p.pos = { frand(0.f, float(size_.x)), frand(0.f, float(size_.y)) };
-
-        const float ang = frand(0.f, 6.2831853f);
-        const float vmag = std::max(30.f, speed_) * frand(0.5f, 1.0f) * 0.5f;
-        p.vel = { vmag * std::cos(ang), vmag * std::sin(ang) };
-
-        // Spiral (no usado aquí)
-        p.angle = 0.f; p.angVel = 0.0f; p.baseRadius = 0.f; p.radiusAmp = 0.f;
-        p.z = 0.f; p.zVel = 0.f; p.phase = 0.f;
-
-        // Nebula
-        p.spinDeg    = frand(0.f, 360.f);
-        p.spinVelDeg = frand(80.f, 260.f) * ((std::rand() % 2) ? 1.f : -1.f);
-        p.scale      = frand(0.75f, 1.25f);
-        p.scaleVel   = frand(-0.25f, 0.25f);
-        p.alpha      = frand(120.f, 240.f);
-        p.alphaVel   = frand(-35.f, 35.f);
-        p.noiseSeed  = frand(0.f, 1000.f);
-
-        p.text.setPosition(p.pos);
-        ps.push_back(std::move(p));
-    }
+    forParticles(std::size_t(N), [&](std::size_t b, std::size_t e) {
+        for (int i = int(b); i < int(e); ++i) {
+            CounterRng rng(cfg_.seed, RngDomain::Particle, std::uint64_t(i));
+            const char ch = alphabet_[rng.below(unsigned(alphabet_.size()))];
+            ps_.baseSize[i] = float(charSize_) * densityScale;
+
+            float t01 = rng.uniform(0.f, 1.f);
+
+            ps_.posX[i] = rng.uniform(0.f, float(size_.x));
+            ps_.posY[i] = rng.uniform(0.f, float(size_.y));
+
+            const float ang = rng.uniform(0.f, 6.2831853f);
+            const float vmag = std::max(30.f, speed_) * rng.uniform(0.5f, 1.0f) * 0.5f;
+            ps_.velX[i] = vmag * std::cos(ang);
+            ps_.velY[i] = vmag * std::sin(ang);
+
+            // Spiral (no usado aquí)
+            ps_.angle[i] = 0.f; ps_.angVel[i] = 0.f; ps_.baseRadius[i] = 0.f; ps_.radiusAmp[i] = 0.f;
+            ps_.z[i] = 0.f; ps_.zVel[i] = 0.f; ps_.phase[i] = 0.f;
+
+            // Nebula
+            ps_.spinDeg[i]    = rng.uniform(0.f, 360.f);
+            ps_.spinVelDeg[i] = rng.uniform(80.f, 260.f) * rng.sign();
+            ps_.scale[i]      = rng.uniform(0.75f, 1.25f);
+            ps_.scaleVel[i]   = rng.uniform(-0.25f, 0.25f);
+            ps_.alpha[i]      = rng.uniform(120.f, 240.f);
+            ps_.alphaVel[i]   = rng.uniform(-35.f, 35.f);
+            ps_.noiseSeed[i]  = rng.uniform(0.f, 1000.f);
+
+            pv_.ch[i]       = ch;
+            pv_.rgba[i]     = nebulaColor(t01, 200.f).toInteger();
+            pv_.x[i]        = ps_.posX[i];
+            pv_.y[i]        = ps_.posY[i];
+            pv_.rot[i]      = ps_.spinDeg[i];
+            pv_.scale[i]    = ps_.scale[i];
+            pv_.charSize[i] = ps_.baseSize[i];
+            pv_.prevX[i]    = pv_.x[i];
+            pv_.prevY[i]    = pv_.y[i];
+
+            if (texts) {
+                // El origen (centro del glifo) no cambia: se fija una sola vez
+                sf::Text& t = psText_[i];
+                t.setFont(font);
+                t.setCharacterSize(unsigned(ps_.baseSize[i]));
+                t.setString(std::string(1, ch));
+                sf::FloatRect lb = glyphBox(ch, ps_.baseSize[i]);
+                t.setOrigin(lb.left + lb.width * 0.5f, lb.top + lb.height * 0.5f);
+                t.setFillColor(sf::Color(pv_.rgba[i]));
+                t.setPosition(pv_.x[i], pv_.y[i]);
+            }
+        }
+    });
 }
 
 // -------------------- campo de flujo + color Nebula --------------------
-sf::Vector2f TextRender::nebulaFlowField(const sf::Vector2f& p, float seed, float t) const {
-    (void)p;
+sf::Vector2f TextRender::nebulaFlowField(float seed, float t) const {
     float nx = std::sin(0.08f * t + seed * 0.71f);
     float ny = std::cos(0.11f * t + seed * 1.31f);
     return { 12.f * nx, 12.f * ny };
@@ -305,275 +916,536 @@ sf::Color TextRender::nebulaColor(float t01, float alpha) const {
 }
 
 // -------------------- update Nebula (partículas) --------------------
-void TextRender::updateNebula(Particle& p, float dt) {
-    sf::Vector2f flow = nebulaFlowField(p.pos, p.noiseSeed, time_);
-    p.vel.x += flow.x * dt;
-    p.vel.y += flow.y * dt;
+void TextRender::updateNebula(std::size_t i, float dt) {
+    sf::Vector2f flow = nebulaFlowField(ps_.noiseSeed[i], time_);
+    float vx = ps_.velX[i] + flow.x * dt;
+    float vy = ps_.velY[i] + flow.y * dt;
 
     float vmax = std::max(40.f, speed_) * 0.5f;
-    float vlen = std::sqrt(p.vel.x*p.vel.x + p.vel.y*p.vel.y);
-    if (vlen > vmax) { p.vel.x *= vmax/vlen; p.vel.y *= vmax/vlen; }
-
-    p.pos += p.vel * dt;
-
-    p.spinDeg += p.spinVelDeg * dt;
-    p.scale += p.scaleVel * dt;
-    if (p.scale < 0.7f) { p.scale = 0.7f; p.scaleVel = std::abs(p.scaleVel); }
-    if (p.scale > 1.4f) { p.scale = 1.4f; p.scaleVel = -std::abs(p.scaleVel); }
-
-    p.alpha += p.alphaVel * dt;
-    if (p.alpha < 90.f)  { p.alpha = 90.f;  p.alphaVel = std::abs(p.alphaVel); }
-    if (p.alpha > 255.f) { p.alpha = 255.f; p.alphaVel = -std::abs(p.alphaVel); }
-
-    float t01 = 0.5f + 0.5f * std::sin(0.7f * time_ + p.noiseSeed * 0.9f);
-    sf::Color col = nebulaColor(t01, p.alpha);
-    p.text.setFillColor(col);
-
-    sf::FloatRect lb = p.text.getLocalBounds();
-    p.text.setOrigin(lb.left + lb.width * 0.5f, lb.top + lb.height * 0.5f);
-    p.text.setPosition(p.pos);
-    p.text.setRotation(p.spinDeg);
-    p.text.setScale(p.scale, p.scale);
+    float vlen = std::sqrt(vx*vx + vy*vy);
+    if (vlen > vmax) { vx *= vmax/vlen; vy *= vmax/vlen; }
+
+    ps_.velX[i] = vx;
+    ps_.velY[i] = vy;
+    ps_.posX[i] += vx * dt;
+    ps_.posY[i] += vy * dt;
+
+    ps_.spinDeg[i] += ps_.spinVelDeg[i] * dt;
+
+    float& scale = ps_.scale[i];
+    float& scaleVel = ps_.scaleVel[i];
+    scale += scaleVel * dt;
+    if (scale < 0.7f) { scale = 0.7f; scaleVel = std::abs(scaleVel); }
+    if (scale > 1.4f) { scale = 1.4f; scaleVel = -std::abs(scaleVel); }
+
+    float& alpha = ps_.alpha[i];
+    float& alphaVel = ps_.alphaVel[i];
+    alpha += alphaVel * dt;
+    if (alpha < 90.f)  { alpha = 90.f;  alphaVel = std::abs(alphaVel); }
+    if (alpha > 255.f) { alpha = 255.f; alphaVel = -std::abs(alphaVel); }
+
+    float t01 = 0.5f + 0.5f * std::sin(0.7f * time_ + ps_.noiseSeed[i] * 0.9f);
+    pv_.rgba[i]  = nebulaColor(t01, alpha).toInteger();
+    pv_.x[i]     = ps_.posX[i];
+    pv_.y[i]     = ps_.posY[i];
+    pv_.rot[i]   = ps_.spinDeg[i];
+    pv_.scale[i] = scale;
 }
 
 // -------------------- lluvia Matrix --------------------
-void TextRender::initRain(int approxTotalGlyphs, const sf::Font& font) {
-    drops.clear();
-
-    sf::Text probe("M", font, charSize_);
-    float glyphW = probe.getLocalBounds().width;
+// Dos pasadas paralelas por columna: largo y cabeza, prefijo CSR (O(columnas))
+// y luego los caracteres de cada gota en su tramo. El flujo RNG de la columna
+// se reanuda en la segunda pasada (seek), asi que no importa quien la haga.
+void TextRender::initRain(int approxTotalGlyphs, const sf::Font&) {
+    float glyphW = glyphBox('M', float(charSize_)).width;
     if (glyphW <= 0.f) glyphW = charSize_ * 0.6f;
-    float spacing = std::max(14.f, charSize_ * 1.05f);
+    const float spacing = std::max(14.f, charSize_ * 1.05f);
 
     const float cellW = std::max(8.f, glyphW * 1.1f);
-    int cols = std::max(1, int(std::floor(size_.x / cellW)));
+    const int cols = std::max(1, int(std::floor(size_.x / cellW)));
 
-    int avgLen = std::max(6, approxTotalGlyphs / std::max(1, cols));
-    drops.reserve(cols);
+    const int avgLen = std::max(6, approxTotalGlyphs / std::max(1, cols));
+    const float H = float(size_.y);
+    drops.assign(cols, Drop{});
+    rainHeadY_.assign(cols, 0.f);
+    rainPrevHeadY_.assign(cols, 0.f);
+    rainFlick_.assign(cols, -1);
+    rainStart_.assign(std::size_t(cols) + 1, 0);
+
+    par_->forStatic(std::size_t(cols), [&](std::size_t b, std::size_t e) {
+        for (int c = int(b); c < int(e); ++c) {
+            CounterRng rng(cfg_.seed, RngDomain::Rain, std::uint64_t(c));
+            Drop& d = drops[c];
+            d.x = (c + 0.5f) * cellW;
+            d.spacing = spacing;
+
+            const int len = std::max(6, int(avgLen * rng.uniform(0.7f, 1.4f)));
+            const float tail = (len - 1) * d.spacing;
+            rainHeadY_[c] = rng.uniform(-tail, H);
+            rainPrevHeadY_[c] = rainHeadY_[c];
+            rainStart_[c + 1] = std::size_t(len);
+        }
+    }, kInitGrain);
+    for (int c = 0; c < cols; ++c) rainStart_[c + 1] += rainStart_[c];
+
+    rainCodes_.resize(rainStart_[cols]);
+    const unsigned nAlpha = unsigned(alphabet_.size());
+    par_->forStatic(std::size_t(cols), [&](std::size_t b, std::size_t e) {
+        for (int c = int(b); c < int(e); ++c) {
+            CounterRng rng(cfg_.seed, RngDomain::Rain, std::uint64_t(c));
+            rng.seek(2);  // tras largo y cabeza
+            for (std::size_t g = rainStart_[c]; g < rainStart_[c + 1]; ++g)
+                rainCodes_[g] = alphabet_[rng.below(nAlpha)];
+        }
+    }, kInitGrain);
+}
 
-    for (int c = 0; c < cols; ++c) {
-        Drop d{};
-        d.x = (c + 0.5f) * cellW;
-        d.spacing = spacing;
+// Fuera de update (p.ej. para medir cada fase aislada): su propio despacho
+void TextRender::updateRain(float dt) {
+    parallelRegion(ParSite::RainCols, drops.size(), [&](int p, int parts) { rainColumns(p, parts, dt); });
+}
 
-        int len = std::max(6, int(avgLen * frand(0.7f, 1.4f)));
-        d.glyphs.clear();
-        d.glyphs.reserve(len);
+void TextRender::updateDashes(float dt) {
+    moveDashLines(dt);
+    parallelRegion(ParSite::DashDots, dashDotX_.size(), [&](int p, int parts) { dashDotsPart(p, parts); });
+}
+
+void TextRender::updatePhase(Phase phase, float dt) {
+    const std::size_t n = activeN_;
+    time_ += dt;
+    forkJoinMs_ = 0.0;
+    switch (phase) {
+    case Phase::Rain:
+        if (mode_ == MotionMode::Rain) updateRain(dt);
+        break;
+    case Phase::Dashes:
+        if (mode_ == MotionMode::Rain) updateDashes(dt);
+        break;
+    case Phase::Bounce:
+        if (mode_ != MotionMode::Bounce) break;
+        parallelRegion(ParSite::Particles, n, [&](int p, int parts) {
+            std::size_t b, e;
+            particleRange(n, p, parts, b, e);
+            for (std::size_t i = b; i < e; ++i) updateBounce(i, dt);
+        });
+        break;
+    case Phase::Spiral:
+        if (mode_ != MotionMode::Spiral) break;
+        parallelRegion(ParSite::Particles, n, [&](int p, int parts) {
+            std::size_t b, e;
+            particleRange(n, p, parts, b, e);
+            for (std::size_t i = b; i < e; ++i) updateSpiral(i, dt);
+        });
+        break;
+    case Phase::Nebula:
+        if (mode_ != MotionMode::Nebula) break;
+        parallelRegion(ParSite::Particles, n, [&](int p, int parts) {
+            std::size_t b, e;
+            particleRange(n, p, parts, b, e);
+            for (std::size_t i = b; i < e; ++i) updateNebula(i, dt);
+        });
+        break;
+    }
+    backFresh_ = true;
+}
 
-        const float H = float(size_.y);
-        const float tail = (len - 1) * d.spacing;
+// Solo estado por columna: cabeza, parpadeo y wrap en una pasada (las
+// lineas punteadas no leen las gotas)
+void TextRender::rainColumns(int part, int parts, float dt) {
+    std::size_t b, e;
+    partRange(drops.size(), part, parts, b, e);
+    advanceRainColumns(b, e, dt);
+}
 
-        d.headY = frand(-tail, H);
+void TextRender::advanceRainColumns(std::size_t b, std::size_t e, float dt) {
+    const float H = float(size_.y);
+    const int frame = int(time_ * 60.0f);
+    for (std::size_t kk = b; kk < e; ++kk) {
+        const int k = int(kk);
+        const Drop& d = drops[k];
+        float& headY = rainHeadY_[k];
+        rainPrevHeadY_[k] = headY;
+        headY += std::max(80.f, speed_) * dt;
+        const bool flickCol = (((unsigned)k*73856093u ^ (unsigned)frame*19349663u) & 7u) == 0u;
+        if (flickCol) rainFlick_[k] = frame;
+
+        const int len = int(rainStart_[k + 1] - rainStart_[k]);
+        if (len <= 0) continue;
 
-        for (int i = 0; i < len; ++i) {
-            char ch = alphabet_[std::rand() % alphabet_.size()];
-            sf::Text g(std::string(1, ch), font, charSize_);
-            if (i == 0) g.setFillColor(headColor());
-            else {
-                float t = float(i) / float(len);
-                unsigned char a = (unsigned char)std::clamp(255 - int(255 * t * 1.2f), 40, 255);
-                g.setFillColor(neonGreen(a));
-            }
-            float y = d.headY - i * d.spacing;
-            g.setPosition(d.x, y);
-            d.glyphs.push_back(std::move(g));
-        }
+        const float tail   = (len - 1) * d.spacing;
+        const float period = H + tail + d.spacing;
+        const float limit  = H + tail + d.spacing;
 
-        drops.push_back(std::move(d));
+        if (headY > limit) {
+            float over  = headY - limit;
+            float steps = std::floor(over / period) + 1.f;
+            headY -= steps * period;
+        }
     }
 }
 
-void TextRender::updateRain(float dt) {
+// Glifo i de la gota k: posicion con wrap vertical, caracter (base o el del
+// ultimo parpadeo de la columna) y color de estela. Lo llaman los dos renders.
+TextRender::RainGlyph TextRender::rainGlyph(const FrameView& v, int k, int i) const {
+    const Drop& d = drops[k];
+    const int len = int(rainStart_[k + 1] - rainStart_[k]);
     const float H = float(size_.y);
-    const int frame = int(time_ * 60.0f);
-
-    #pragma omp parallel for schedule(static)
-    for (int k = 0; k < (int)drops.size(); ++k) {
-        drops[k].headY += std::max(80.f, speed_) * dt;
+    const float tail   = (len - 1) * d.spacing;
+    const float period = H + tail + d.spacing;
+
+    RainGlyph g;
+    float yWrapped = std::fmod(v.headY[k] - i * d.spacing + period, period);
+    if (yWrapped < 0.f) yWrapped += period;
+    g.y = yWrapped - tail;
+
+    g.ch = rainCodes_[rainStart_[k] + i];
+    const int flick = v.flick[k];
+    if (flick >= 0) {
+        const unsigned f = (unsigned)flick;
+        const bool flickGly = (((unsigned)i*83492791u ^ f*2971215073u) % 10) == 0u;
+        if (flickGly) g.ch = alphabet_[(k + i + flick) % (int)alphabet_.size()];
     }
 
-    int maxLen = 0;
-    #pragma omp parallel for reduction(max:maxLen) schedule(static)
-    for (int k = 0; k < (int)drops.size(); ++k) {
-        int len = (int)drops[k].glyphs.size();
-        if (len > maxLen) maxLen = len;
+    if (i == 0) {
+        g.color = headColor();
+        g.color.a = (unsigned char)std::clamp(200 + int(55 * std::sin(v.time * 6.f + k)), 160, 255);
+    } else {
+        const float t = float(i) / float(len);
+        g.color = neonGreen((unsigned char)std::clamp(255 - int(255 * t * 1.2f), 40, 255));
     }
+    return g;
+}
 
-    #pragma omp parallel for collapse(2) schedule(static)
-    for (int k = 0; k < (int)drops.size(); ++k) {
-        for (int i = 0; i < maxLen; ++i) {
-            if (i >= (int)drops[k].glyphs.size()) continue;
-            Drop& d = drops[k];
-
-            const int len = (int)d.glyphs.size();
-            const float tail   = (len - 1) * d.spacing;
-            const float period = H + tail + d.spacing;
-
-            float y = d.headY - i * d.spacing;
-            float yWrapped = std::fmod(y + period, period);
-            if (yWrapped < 0.f) yWrapped += period;
-            y = yWrapped - tail;
-
-            bool flickCol = (((unsigned)k*73856093u ^ (unsigned)frame*19349663u) & 7u) == 0u;
-            bool flickGly = (((unsigned)i*83492791u ^ (unsigned)frame*2971215073u) % 10) == 0u;
-            if (flickCol && flickGly) {
-                char ch = alphabet_[(k + i + frame) % (int)alphabet_.size()];
-                d.glyphs[i].setString(std::string(1, ch));
-            }
+// -------------------- render por lotes (Rain) --------------------
+// Dos triangulos por glifo con la misma geometria que sf::Text (linea base en
+// y + charSize, 1 px de padding). k escala un glifo de charSize_ a otro tamano,
+// asi glifos y puntos salen de la misma pagina de textura y de un solo draw.
+static inline void putGlyphQuad(sf::Vertex* v, const sf::Glyph& g,
+                                float x, float y, float k, float charSize, sf::Color col) {
+    const float pad = 1.f;
+    const float l = x + k * (g.bounds.left - pad);
+    const float t = y + k * (charSize + g.bounds.top - pad);
+    const float r = x + k * (g.bounds.left + g.bounds.width + pad);
+    const float b = y + k * (charSize + g.bounds.top + g.bounds.height + pad);
+
+    const float u1 = float(g.textureRect.left) - pad;
+    const float v1 = float(g.textureRect.top) - pad;
+    const float u2 = float(g.textureRect.left + g.textureRect.width) + pad;
+    const float v2 = float(g.textureRect.top + g.textureRect.height) + pad;
+
+    v[0] = sf::Vertex({l, t}, col, {u1, v1});
+    v[1] = sf::Vertex({r, t}, col, {u2, v1});
+    v[2] = sf::Vertex({l, b}, col, {u1, v2});
+    v[3] = sf::Vertex({l, b}, col, {u1, v2});
+    v[4] = sf::Vertex({r, t}, col, {u2, v1});
+    v[5] = sf::Vertex({r, b}, col, {u2, v2});
+}
 
-            if (i == 0) {
-                sf::Color c = headColor();
-                c.a = (unsigned char)std::clamp(200 + int(55 * std::sin(time_ * 6.f + k)), 160, 255);
-                d.glyphs[i].setFillColor(c);
-            }
+// Columnas dibujadas con detail_: la columna k entra si frac(k * phi) < detail_
+// (secuencia de baja discrepancia: cualquier fraccion queda repartida a lo
+// ancho de la pantalla y subir detail_ solo anade columnas)
+void TextRender::selectRainColumns() {
+    rainActive_.clear();
+    rainActiveStart_.assign(1, 0);
+    for (int k = 0; k < (int)drops.size(); ++k) {
+        const float r = std::fmod(float(k) * 0.618034f, 1.f);
+        if (detail_ < 1.f && r >= detail_) continue;
+        rainActive_.push_back(k);
+        rainActiveStart_.push_back(rainActiveStart_.back() + (rainStart_[k + 1] - rainStart_[k]));
+    }
+}
 
-            d.glyphs[i].setPosition(d.x, y);
-        }
+void TextRender::setDetail(float detail) {
+    detail_ = std::clamp(detail, 0.05f, 1.f);
+    if (mode_ == MotionMode::Rain) {
+        selectRainColumns();
+        return;
     }
+    activeN_ = std::min<std::size_t>(ps_.size(), std::max<long>(1, std::lround(double(detail_) * double(ps_.size()))));
+    if (cfg_.taskGraph) buildGraph();
+}
 
-    #pragma omp parallel for schedule(static)
-    for (int k = 0; k < (int)drops.size(); ++k) {
-        Drop& d = drops[k];
-        const int len = (int)d.glyphs.size();
-        if (len <= 0) continue;
+// Tamano del VertexArray y de la ruta sin lotes (cambia solo en init/resize)
+void TextRender::layoutRainBatch() {
+    selectRainColumns();
 
-        const float tail   = (len - 1) * d.spacing;
-        const float period = H + tail + d.spacing;
-        const float limit  = H + tail + d.spacing;
+    // En headless no hay render: ni vertices ni sf::Text
+    rainVA_.resize(cfg_.headless ? 0 : 6 * (rainCodes_.size() + dashDots_.size()));
 
-        if (d.headY > limit) {
-            float over  = d.headY - limit;
-            float steps = std::floor(over / period) + 1.f;
-            d.headY -= steps * period;
-        }
+    // La ruta sin lotes necesita un sf::Text por glifo de lluvia
+    rainText_.clear();
+    if (!cfg_.batchRain && !cfg_.headless && font_) {
+        rainText_.assign(rainCodes_.size(), sf::Text("0", *font_, charSize_));
     }
 }
 
+void TextRender::renderRainBatched(sf::RenderWindow& window, const FrameView& v) {
+    if (!font_ || rainStart_.empty()) return;
+    const float cs = float(charSize_);
+    const std::size_t nGlyphs = rainActiveStart_.back();
+    const std::size_t nDots = dashDots_.size();
+
+    // Recorrido plano de las columnas activas: cada hilo escribe su tramo del
+    // VertexArray, sin carreras y con el mismo numero de glifos aunque las
+    // gotas tengan largos distintos
+    const int parts = beginSite(ParSite::RainFill, nGlyphs + nDots);
+    const double tFill = wallNow();
+    const int team = runSite(ParSite::RainFill, parts, [&](int p) {
+        std::size_t b, e;
+        partRange(nGlyphs, p, parts, b, e);
+        forCsrBlock(rainActiveStart_, b, e, [&](int a, int i, std::size_t g) {
+            const int k = rainActive_[a];
+            const RainGlyph r = rainGlyph(v, k, i);
+            putGlyphQuad(&rainVA_[6 * g], glyphs_[(unsigned char)r.ch & 127u],
+                         drops[k].x, r.y, 1.f, cs, r.color);
+        });
+        partRange(nDots, p, parts, b, e);
+        forCsrBlock(dashStart_, b, e, [&](int li, int, std::size_t d) {
+            const sf::Text& dot = dashDots_[d];
+            const float k = float(dot.getCharacterSize()) / cs;
+            putGlyphQuad(&rainVA_[6 * (nGlyphs + d)], glyphs_['.'],
+                         v.dotX[d], dashes[li].y, k, cs, dot.getFillColor());
+        });
+    });
+    endSite(ParSite::RainFill, team, (wallNow() - tFill) * 1e3);
+
+    sf::RenderStates states(&font_->getTexture(charSize_));
+    if (nGlyphs + nDots > 0) window.draw(&rainVA_[0], 6 * (nGlyphs + nDots), sf::Triangles, states);
+}
+
 // -------------------- líneas punteadas --------------------
 void TextRender::initDashes(const sf::Font& font, int count) {
     dashes.clear();
     dashes.reserve(count);
+    dashDots_.clear();
+    dashDotX_.clear();
+    dashPrevDotX_.clear();
+    dashStart_.assign(1, 0);
 
     unsigned int dotCharSize = std::max(10u, charSize_ / 2);
 
-    sf::Text probe(".", font, dotCharSize);
-    float dotW = probe.getLocalBounds().width;
+    float dotW = glyphBox('.', float(dotCharSize)).width;
     if (dotW <= 0.f) dotW = dotCharSize * 0.45f;
 
     for (int k = 0; k < count; ++k) {
+        CounterRng rng(cfg_.seed, RngDomain::Dash, std::uint64_t(k));
         DashLine L{};
         L.dotWidth = dotW;
         L.spacing  = std::max(8.f, dotW * 1.8f);
 
-        float frac     = frand(0.12f, 0.28f);
+        float frac     = rng.uniform(0.12f, 0.28f);
         float targetW  = std::max(120.f, float(size_.x) * frac);
         int   nDots    = std::max(5, int(std::round(targetW / L.spacing)));
         float totalW   = (nDots - 1) * L.spacing + L.dotWidth;
 
-        L.y = frand(dotCharSize * 1.2f, float(size_.y) - dotCharSize * 1.8f);
+        L.y = rng.uniform(dotCharSize * 1.2f, float(size_.y) - dotCharSize * 1.8f);
         float travel = std::max(50.f, float(size_.x) - totalW);
-        float T      = frand(2.5f, 5.0f);
+        float T      = rng.uniform(2.5f, 5.0f);
         float vxMag  = travel / T;
-        L.vx         = ((std::rand() % 2) ? vxMag : -vxMag);
+        L.vx         = rng.sign() * vxMag;
 
-        L.xLeft = frand(0.f, float(size_.x) - totalW);
+        L.xLeft = rng.uniform(0.f, float(size_.x) - totalW);
 
-        L.dots.reserve(nDots);
         for (int i = 0; i < nDots; ++i) {
             sf::Text dot(".", font, dotCharSize);
             sf::Color c = neonGreen(220);
             if (i % 2 == 1) c.a = 180;
             dot.setFillColor(c);
             dot.setPosition(L.xLeft + i * L.spacing, L.y);
-            L.dots.push_back(std::move(dot));
+            dashDots_.push_back(std::move(dot));
+            dashDotX_.push_back(L.xLeft + i * L.spacing);
+            dashPrevDotX_.push_back(dashDotX_.back());
         }
+        dashStart_.push_back(dashDots_.size());
 
         dashes.push_back(std::move(L));
     }
 }
 
-void TextRender::updateDashes(float dt) {
-    #pragma omp parallel for schedule(static)
-    for (int li = 0; li < (int)dashes.size(); ++li) {
-        DashLine& L = dashes[li];
+// Una decena de lineas a lo sumo: en el hilo llamador, antes del despacho
+// de los puntos (que leen xLeft de su linea)
+void TextRender::moveDashLines(float dt) {
+    for (int li = 0; li < (int)dashes.size(); ++li) moveDashLine(li, dt);
+}
 
-        L.xLeft += L.vx * dt;
+// Recorrido plano de todos los puntos: sin iteraciones vacias ni maximo previo
+void TextRender::dashDotsPart(int part, int parts) {
+    std::size_t b, e;
+    partRange(dashDotX_.size(), part, parts, b, e);
+    placeDashDots(b, e);
+}
 
-        const int n = (int)L.dots.size();
-        if (n == 0) continue;
+void TextRender::moveDashLine(int li, float dt) {
+    DashLine& L = dashes[li];
 
-        float totalW    = (n - 1) * L.spacing + L.dotWidth;
-        float leftBound  = 0.f;
-        float rightBound = std::max(0.f, float(size_.x) - totalW);
+    L.xLeft += L.vx * dt;
 
-        if (L.xLeft < leftBound)  { L.xLeft = leftBound;  L.vx =  std::fabs(L.vx); }
-        if (L.xLeft > rightBound) { L.xLeft = rightBound; L.vx = -std::fabs(L.vx); }
-    }
+    const int n = int(dashStart_[li + 1] - dashStart_[li]);
+    if (n == 0) return;
 
-    int maxDots = 0;
-    #pragma omp parallel for reduction(max:maxDots) schedule(static)
-    for (int li = 0; li < (int)dashes.size(); ++li) {
-        int n = (int)dashes[li].dots.size();
-        if (n > maxDots) maxDots = n;
-    }
+    float totalW    = (n - 1) * L.spacing + L.dotWidth;
+    float leftBound  = 0.f;
+    float rightBound = std::max(0.f, float(size_.x) - totalW);
 
-    #pragma omp parallel for collapse(2) schedule(static)
-    for (int li = 0; li < (int)dashes.size(); ++li) {
-        for (int i = 0; i < maxDots; ++i) {
-            if (i >= (int)dashes[li].dots.size()) continue;
-            DashLine& L = dashes[li];
-            L.dots[i].setPosition(L.xLeft + i * L.spacing, L.y);
-        }
-    }
+    if (L.xLeft < leftBound)  { L.xLeft = leftBound;  L.vx =  std::fabs(L.vx); }
+    if (L.xLeft > rightBound) { L.xLeft = rightBound; L.vx = -std::fabs(L.vx); }
 }
 
-// -------------------- bounce/spiral --------------------
-void TextRender::updateBounce(Particle& p, float dt) {
-    #pragma omp critical
-    {
-        p.pos += p.vel * dt;
-    }
+void TextRender::placeDashDots(std::size_t b, std::size_t e) {
+    forCsrBlock(dashStart_, b, e, [&](int li, int i, std::size_t d) {
+        const DashLine& L = dashes[li];
+        dashPrevDotX_[d] = dashDotX_[d];
+        dashDotX_[d] = L.xLeft + float(i) * L.spacing;
+    });
+}
 
-    const sf::FloatRect bounds = p.text.getLocalBounds();
+// -------------------- bounce/spiral --------------------
+void TextRender::updateBounce(std::size_t i, float dt) {
+    float x = ps_.posX[i] + ps_.velX[i] * dt;
+    float y = ps_.posY[i] + ps_.velY[i] * dt;
+
+    // Caja del caracter al tamano del paso anterior (con pipeline puede estar
+    // en la vista publicada: pv_ trae entonces el de hace dos pasos)
+    const ParticleView& last = latestView();
+    const sf::FloatRect bounds = glyphBox(last.ch[i], last.charSize[i]);
     const float w = bounds.width, h = bounds.height;
 
-    if (p.pos.x < 0.f) { p.pos.x = 0.f; p.vel.x = -p.vel.x; }
-    if (p.pos.x + w > float(size_.x)) { p.pos.x = float(size_.x) - w; p.vel.x = -p.vel.x; }
-    if (p.pos.y < 0.f) { p.pos.y = 0.f; p.vel.y = -p.vel.y; }
-    if (p.pos.y + h > float(size_.y)) { p.pos.y = float(size_.y) - h; p.vel.y = -p.vel.y; }
+    if (x < 0.f) { x = 0.f; ps_.velX[i] = -ps_.velX[i]; }
+    if (x + w > float(size_.x)) { x = float(size_.x) - w; ps_.velX[i] = -ps_.velX[i]; }
+    if (y < 0.f) { y = 0.f; ps_.velY[i] = -ps_.velY[i]; }
+    if (y + h > float(size_.y)) { y = float(size_.y) - h; ps_.velY[i] = -ps_.velY[i]; }
+    ps_.posX[i] = x;
+    ps_.posY[i] = y;
 
-    const float t = std::sin((p.pos.x + p.pos.y) * 0.01f);
+    const float t = std::sin((x + y) * 0.01f);
     const float scale = 1.0f + 0.1f * t;
-    p.text.setCharacterSize(unsigned(std::max(8.f, p.baseSize * scale)));
+    pv_.charSize[i] = std::floor(std::max(8.f, ps_.baseSize[i] * scale));
 
-    p.text.setPosition(p.pos);
+    pv_.x[i] = x;
+    pv_.y[i] = y;
+}
+
+// Choques entre glifos (Bounce). Cada particula calcula SOLO su propia respuesta
+// leyendo el estado anterior de sus vecinos y escribe en buffers aparte, asi que
+// no hay locks ni carreras y el resultado no depende del numero de hilos.
+// Respuesta: media correccion de solape + intercambio elastico (masas iguales)
+// de la componente normal cuando se acercan, promediadas sobre los contactos
+// (Jacobi): con varios vecinos a la vez sumarlas inyecta energia y amontona
+// los glifos contra los bordes.
+void TextRender::collideBounce() {
+    const int n = (int)activeN_;
+    if (n < 2 || collideR_ <= 0.f) return;
+    const float D  = 2.f * collideR_;
+    const float D2 = D * D;
+
+    const int gridParts = beginSite(ParSite::GridBuild, std::size_t(n));
+    const double tGrid = wallNow();
+    int gridTeam = 1;
+    SiteBackend gridPar(*this, ParSite::GridBuild);
+    grid_.build(ps_.posX.data(), ps_.posY.data(), n, D, size_, gridPar, gridParts, gridTeam);
+    endSite(ParSite::GridBuild, gridTeam, (wallNow() - tGrid) * 1e3);
+
+    // Buffers del tamano total: las inactivas (setDetail) pasan tal cual
+    const std::size_t total = ps_.size();
+    nPosX_.resize(total); nPosY_.resize(total); nVelX_.resize(total); nVelY_.resize(total);
+    if (std::size_t(n) < total) {
+        std::copy(ps_.posX.begin() + n, ps_.posX.end(), nPosX_.begin() + n);
+        std::copy(ps_.posY.begin() + n, ps_.posY.end(), nPosY_.begin() + n);
+        std::copy(ps_.velX.begin() + n, ps_.velX.end(), nVelX_.begin() + n);
+        std::copy(ps_.velY.begin() + n, ps_.velY.end(), nVelY_.begin() + n);
+    }
+    const float* px = ps_.posX.data(); const float* py = ps_.posY.data();
+    const float* vx = ps_.velX.data(); const float* vy = ps_.velY.data();
+    const int* start = grid_.cellStart();
+    const int* order = grid_.order();
+    const int cols = grid_.cols(), rows = grid_.rows();
+
+    // Por celdas (localidad); densidad variable => reparto dinamico
+    ChunkCounter cells(std::size_t(cols) * rows, 16);
+    parallelRegion(ParSite::Collide, std::size_t(cols) * rows, [&](int, int) {
+        std::size_t c0, c1;
+        while (cells.next(c0, c1)) {
+            for (int c = int(c0); c < int(c1); ++c) {
+                const int cx = c % cols, cy = c / cols;
+                for (int k = start[c]; k < start[c + 1]; ++k) {
+                    const int i = order[k];
+                    const float xi = px[i], yi = py[i];
+                    float dx = 0.f, dy = 0.f, dvx = 0.f, dvy = 0.f;
+                    int contacts = 0;
+
+                    for (int ny = std::max(0, cy - 1); ny <= std::min(rows - 1, cy + 1); ++ny)
+                    for (int nx = std::max(0, cx - 1); nx <= std::min(cols - 1, cx + 1); ++nx) {
+                        const int nc = ny * cols + nx;
+                        for (int m = start[nc]; m < start[nc + 1]; ++m) {
+                            const int j = order[m];
+                            if (j == i) continue;
+                            const float ex = px[j] - xi, ey = py[j] - yi;
+                            const float d2 = ex * ex + ey * ey;
+                            if (d2 >= D2) continue;
+
+                            float d, ux, uy;
+                            if (d2 > 1e-8f) {
+                                d = std::sqrt(d2);
+                                ux = ex / d; uy = ey / d;
+                            } else {
+                                // Coincidentes (p.ej. apiladas en una esquina): direccion
+                                // fija por el par, opuesta para i y j
+                                const unsigned lo = unsigned(std::min(i, j)), hi = unsigned(std::max(i, j));
+                                const float a = float((lo * 2654435761u) ^ (hi * 40503u)) * 1.4629180792671596e-9f;
+                                const float sgn = (i < j) ? 1.f : -1.f;
+                                d = 0.f;
+                                ux = sgn * std::cos(a); uy = sgn * std::sin(a);
+                            }
+                            ++contacts;
+                            const float push = 0.5f * (D - d);
+                            dx -= push * ux;
+                            dy -= push * uy;
+
+                            const float rel = (vx[i] - vx[j]) * ux + (vy[i] - vy[j]) * uy;
+                            if (rel > 0.f) { dvx -= rel * ux; dvy -= rel * uy; }
+                        }
+                    }
+                    if (contacts > 1) {
+                        const float inv = 1.f / float(contacts);
+                        dx *= inv; dy *= inv; dvx *= inv; dvy *= inv;
+                    }
+                    nPosX_[i] = xi + dx;    nPosY_[i] = yi + dy;
+                    nVelX_[i] = vx[i] + dvx; nVelY_[i] = vy[i] + dvy;
+                }
+            }
+        }
+    });
+    ps_.posX.swap(nPosX_); ps_.posY.swap(nPosY_);
+    ps_.velX.swap(nVelX_); ps_.velY.swap(nVelY_);
 }
 
-void TextRender::updateSpiral(Particle& p, float dt) {
-    p.angle += p.angVel * dt;
-    const float r = p.baseRadius + p.radiusAmp * std::sin(p.phase + p.angle * 0.9f);
+void TextRender::updateSpiral(std::size_t i, float dt) {
+    float& angle = ps_.angle[i];
+    angle += ps_.angVel[i] * dt;
+    const float r = ps_.baseRadius[i] + ps_.radiusAmp[i] * std::sin(ps_.phase[i] + angle * 0.9f);
 
-    p.z += p.zVel * dt;
+    float& z = ps_.z[i];
+    float& zVel = ps_.zVel[i];
+    z += zVel * dt;
     const float Zmax = 350.f;
-    if (p.z >  Zmax) { p.z =  Zmax; p.zVel = -std::abs(p.zVel); }
-    if (p.z < -Zmax) { p.z = -Zmax; p.zVel =  std::abs(p.zVel); }
+    if (z >  Zmax) { z =  Zmax; zVel = -std::abs(zVel); }
+    if (z < -Zmax) { z = -Zmax; zVel =  std::abs(zVel); }
 
     const sf::Vector2f c(size_.x * 0.5f, size_.y * 0.5f);
-    const float X = r * std::cos(p.angle);
-    const float Y = r * std::sin(p.angle);
+    const float X = r * std::cos(angle);
+    const float Y = r * std::sin(angle);
 
     const float f = 500.f;
-    const float s = f / (f + p.z);
+    const float s = f / (f + z);
     const float x2d = c.x + X * s;
     const float y2d = c.y + Y * s + 25.f * dt;
 
     const float uiScale = std::clamp(s, 0.5f, 1.8f);
-    p.text.setCharacterSize(unsigned(std::max(8.f, p.baseSize * uiScale)));
+    pv_.charSize[i] = std::floor(std::max(8.f, ps_.baseSize[i] * uiScale));
 
-    sf::Color col = p.text.getFillColor();
     const float alpha = std::clamp(180.f + 70.f * (s - 1.f), 60.f, 255.f);
-    col.a = static_cast<sf::Uint8>(alpha);
-    p.text.setFillColor(col);
+    pv_.rgba[i] = (pv_.rgba[i] & 0xFFFFFF00u) | std::uint32_t(alpha);
 
-    p.text.setPosition(x2d, y2d);
+    pv_.x[i] = x2d;
+    pv_.y[i] = y2d;
 }
@@ -0,0 +1,89 @@
+// src/WorkPool.cpp
+#include "WorkPool.h"
+#include <algorithm>
+#include "Affinity.h"
+
+static thread_local int t_worker = 0;
+
+int WorkPool::currentWorker() { return t_worker; }
+
+WorkPool::WorkPool(int threads) {
+    const int n = std::max(1, threads);
+    queues_.reserve(n);
+    for (int w = 0; w < n; ++w) queues_.push_back(std::make_unique<Queue>());
+    threads_.reserve(n - 1);
+    for (int w = 1; w < n; ++w) threads_.emplace_back([this, w] { workerLoop(w); });
+}
+
+WorkPool::~WorkPool() {
+    { std::lock_guard<std::mutex> lk(sleepM_); stop_ = true; }
+    sleepCv_.notify_all();
+    for (std::thread& t : threads_) t.join();
+}
+
+int WorkPool::pin(const std::vector<int>& cpus) {
+    if (cpus.empty()) return 0;
+    const int n = int(cpus.size());
+    int pinned = pinCurrentThread(cpus[0]) ? 1 : 0;
+    for (int w = 1; w < size(); ++w)
+        pinned += pinThread(threads_[w - 1], cpus[w % n]) ? 1 : 0;
+    return pinned;
+}
+
+void WorkPool::push(const Job& job, int worker) {
+    Queue& q = *queues_[std::clamp(worker, 0, size() - 1)];
+    { std::lock_guard<std::mutex> lk(q.m); q.jobs.push_back(job); }
+    queued_.fetch_add(1, std::memory_order_release);
+    // Tomar el mutex antes de avisar: un hilo que acaba de ver queued_ == 0
+    // ya esta dentro de wait() y no pierde el aviso
+    { std::lock_guard<std::mutex> lk(sleepM_); }
+    sleepCv_.notify_one();
+}
+
+bool WorkPool::popLocal(int w, Job& out) {
+    Queue& q = *queues_[w];
+    std::lock_guard<std::mutex> lk(q.m);
+    if (q.jobs.empty()) return false;
+    out = q.jobs.back();
+    q.jobs.pop_back();
+    return true;
+}
+
+// Recorre las demas colas empezando por la siguiente (reparte a las victimas)
+bool WorkPool::steal(int w, Job& out) {
+    const int n = size();
+    for (int k = 1; k < n; ++k) {
+        Queue& q = *queues_[(w + k) % n];
+        std::lock_guard<std::mutex> lk(q.m);
+        if (q.jobs.empty()) continue;
+        out = q.jobs.front();
+        q.jobs.pop_front();
+        return true;
+    }
+    return false;
+}
+
+bool WorkPool::tryRun(int w) {
+    Job job;
+    if (!popLocal(w, job) && !steal(w, job)) return false;
+    queued_.fetch_sub(1, std::memory_order_acq_rel);
+    job.fn(job.ctx, job.arg, w);
+    return true;
+}
+
+void WorkPool::workerLoop(int w) {
+    t_worker = w;
+    for (;;) {
+        if (tryRun(w)) continue;
+        std::unique_lock<std::mutex> lk(sleepM_);
+        sleepCv_.wait(lk, [this] { return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+        if (stop_) return;
+    }
+}
+
+void WorkPool::help(const std::atomic<int>& remaining) {
+    const int w = t_worker;
+    while (remaining.load(std::memory_order_acquire) > 0) {
+        if (!tryRun(w)) std::this_thread::yield();
+    }
+}
@@ -7,6 +7,19 @@
 #include <fstream>
 #include <chrono>
 #include <iomanip>
+#include <sstream>
+#include <array>
+#include <vector>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <cstdint>
+#include <ctime>
+#include "Affinity.h"
+#include "BenchLog.h"
 #include "TextRender.h"
 
 #ifdef _OPENMP
@@ -27,14 +40,36 @@ struct CliOptions {
     int nChars = 200;
     int width  = 800;
     int height = 600;
-    bool forceSequential = false;
+    bool forceSequential = false; // --seq: backend serial con 1 hilo
     int threads = 0;
+    Backend backend = Backend::Omp; // --backend omp|pool|serial
     MotionMode mode = MotionMode::Rain;
     float speed = 160.f;
     Palette palette = Palette::Mono;
 
     std::string benchPath;
     int benchFrames = 0;
+
+    bool headless = false;     // solo simulacion: sin ventana ni contexto GL
+    float fixedDt = 1.f / 60.f; // dt fijo del modo headless
+    bool batchRain = true;     // --render batch|text
+    SimdKernel kernel = SimdKernel::Auto; // --kernel
+    bool collisions = false;   // --collide (Bounce)
+    bool seedSet = false;      // --seed S (si no, se toma del reloj y se imprime)
+    std::uint64_t seed = 0;
+    bool pipeline = false;     // --pipeline: update en un hilo aparte
+    float simHz = 0.f;         // --sim-hz H: paso fijo 1/H con interpolacion (0 = dt del reloj)
+    int maxSteps = 5;          // --max-steps K: tope de pasos por frame
+    bool taskGraph = false;    // --taskgraph: update como grafo de tareas
+    std::string benchTasksPath; // --bench-tasks FILE: tiempos por tarea del grafo
+    std::string dumpGrainPath;  // --dump-grain FILE: sitios, elementos y si corrieron en paralelo
+    std::string benchThreadsPath; // --bench-threads FILE: trabajo y espera por hilo y sitio
+    bool autotune = false;      // --autotune: elige --threads con un barrido headless
+    std::string autotuneCache;  // --autotune-cache FILE: resultados por CPU y configuracion
+    float budgetMs = 0.f;       // --budget MS: presupuesto de frame (0 = sin controlador)
+    PinSpec pin;                // --pin compact|scatter|LISTA: afinidad de los hilos
+    std::string benchSuitePath;    // --bench-suite FILE: matriz de escenas en un proceso
+    std::string benchSuiteOutPath; // --bench-suite-out FILE: CSV resumen (defecto: bench/suite_*.csv)
 };
 
 static void print_usage(const char* prog) {
@@ -44,13 +79,33 @@ static void print_usage(const char* prog) {
         << "  N                     Numero de caracteres (defecto: 200)\n"
         << "  ANCHOxALTO            Resolucion, p.ej. 1024x768 (defecto: 800x600)\n\n"
         << "Opciones:\n"
-        << "  --seq                 Fuerza modo secuencial\n"
+        << "  --seq                 Fuerza modo secuencial (= --backend serial)\n"
         << "  --threads K           Sugerir K hilos\n"
+        << "  --backend omp|pool|serial   Bucles paralelos: OpenMP, pool con robo de trabajo o serial (defecto: omp)\n"
         << "  --mode rain|bounce|spiral|nebula   (defecto: rain)\n"
         << "  --palette mono|neon|rainbow        (defecto: mono)\n"
         << "  --speed V             Velocidad base px/s (defecto: 160)\n"
         << "  --bench FILE          CSV de benchmark\n"
         << "  --bench-frames K      Detener tras K frames\n"
+        << "  --headless            Solo update(dt) sin ventana (exige --bench-frames)\n"
+        << "  --dt S                dt fijo en segundos para --headless (defecto: 1/60)\n"
+        << "  --render batch|text   Rain: 1 VertexArray por frame o 1 draw por glifo (defecto: batch)\n"
+        << "  --kernel auto|avx2|sse|scalar   Kernel de Spiral/Nebula (defecto: auto)\n"
+        << "  --collide             Bounce: choques entre glifos (rejilla uniforme)\n"
+        << "  --seed S              Semilla de la escena (defecto: reloj; se imprime)\n"
+        << "  --pipeline            Simula el frame N+1 mientras dibuja el N (hilo aparte)\n"
+        << "  --sim-hz H            Paso fijo de 1/H s con interpolacion al dibujar (p.ej. 120)\n"
+        << "  --max-steps K         Tope de pasos de --sim-hz por frame (defecto: 5)\n"
+        << "  --taskgraph           update como grafo de tareas en un pool con robo de trabajo\n"
+        << "  --bench-tasks FILE    CSV con tiempos por tarea del grafo (con --taskgraph)\n"
+        << "  --bench-threads FILE  CSV por frame, sitio paralelo y hilo: trabajo (CPU) y espera en la barrera\n"
+        << "  --dump-grain FILE     CSV por frame y sitio paralelo: elementos, partes y si corrio en paralelo\n"
+        << "  --autotune            Elige el numero de hilos midiendo update en headless (tope: --threads)\n"
+        << "  --autotune-cache FILE Guarda/reusa el resultado por CPU, nucleos, modo, N y resolucion\n"
+        << "  --pin compact|scatter|LISTA   Fija los hilos a CPUs (p.ej. 0,2,4-7; defecto: sin fijar)\n"
+        << "  --budget MS           Ajusta detalle e hilos en marcha para que update+dibujo quepa en MS (p.ej. 16.6)\n"
+        << "  --bench-suite FILE    Corre la matriz modos x N x resolucion x hilos de FILE (ver example/suite.txt)\n"
+        << "  --bench-suite-out FILE  CSV resumen de --bench-suite: p50/p95/p99/max por escena\n"
         << "  -h, --help            Ayuda\n";
 }
 
@@ -64,12 +119,46 @@ static bool parse_resolution(const std::string& s, int& w, int& h) {
     return false;
 }
 
+static bool parse_mode(const std::string& m, MotionMode& mode) {
+    if      (m == "rain")   mode = MotionMode::Rain;
+    else if (m == "bounce") mode = MotionMode::Bounce;
+    else if (m == "spiral") mode = MotionMode::Spiral;
+    else if (m == "nebula") mode = MotionMode::Nebula;
+    else return false;
+    return true;
+}
+
+static bool parse_backend(const std::string& b, Backend& backend) {
+    if      (b == "omp")                  backend = Backend::Omp;
+    else if (b == "pool")                 backend = Backend::Pool;
+    else if (b == "serial" || b == "seq") backend = Backend::Serial;
+    else return false;
+    return true;
+}
+
 static bool file_exists(const std::string& path) {
     namespace fs = std::filesystem;
     std::error_code ec;
     return fs::exists(path, ec) && fs::is_regular_file(path, ec);
 }
 
+// Opciones conocidas; las que consumen el siguiente argumento no cuentan como posicionales
+static bool option_has_value(const std::string& a) {
+    return a == "--threads" || a == "--mode" || a == "--palette" || a == "--speed"
+        || a == "--bench" || a == "--bench-frames" || a == "--dt" || a == "--render"
+        || a == "--kernel" || a == "--seed" || a == "--sim-hz" || a == "--max-steps"
+        || a == "--bench-tasks" || a == "--backend" || a == "--dump-grain"
+        || a == "--bench-threads"
+        || a == "--autotune-cache" || a == "--budget" || a == "--pin"
+        || a == "--bench-suite" || a == "--bench-suite-out";
+}
+
+static bool is_option(const std::string& a) {
+    return option_has_value(a) || a == "--seq" || a == "--headless" || a == "--collide"
+        || a == "--pipeline" || a == "--taskgraph" || a == "--autotune"
+        || a == "-h" || a == "--help";
+}
+
 static bool parse_cli(int argc, char** argv, CliOptions& opts) {
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
@@ -86,12 +175,9 @@ static bool parse_cli(int argc, char** argv, CliOptions& opts) {
         }
         if (a == "--mode") {
             if (i + 1 >= argc) { std::cerr << "Error: --mode requiere valor.\n"; return false; }
-            std::string m = argv[++i];
-            if      (m == "rain")   opts.mode = MotionMode::Rain;
-            else if (m == "bounce") opts.mode = MotionMode::Bounce;
-            else if (m == "spiral") opts.mode = MotionMode::Spiral;
-            else if (m == "nebula") opts.mode = MotionMode::Nebula;
-            else { std::cerr << "Error: --mode {rain|bounce|spiral|nebula}\n"; return false; }
+            if (!parse_mode(argv[++i], opts.mode)) {
+                std::cerr << "Error: --mode {rain|bounce|spiral|nebula}\n"; return false;
+            }
             continue;
         }
         if (a == "--palette") {
@@ -119,14 +205,107 @@ static bool parse_cli(int argc, char** argv, CliOptions& opts) {
             if (k <= 0) { std::cerr << "Error: --bench-frames > 0\n"; return false; }
             opts.benchFrames = k; continue;
         }
+        if (a == "--headless") { opts.headless = true; continue; }
+        if (a == "--collide")  { opts.collisions = true; continue; }
+        if (a == "--pipeline") { opts.pipeline = true; continue; }
+        if (a == "--taskgraph") { opts.taskGraph = true; continue; }
+        if (a == "--autotune") { opts.autotune = true; continue; }
+        if (a == "--autotune-cache") {
+            if (i + 1 >= argc) { std::cerr << "Error: --autotune-cache FILE\n"; return false; }
+            opts.autotuneCache = argv[++i]; opts.autotune = true; continue;
+        }
+        if (a == "--bench-threads") {
+            if (i + 1 >= argc) { std::cerr << "Error: --bench-threads FILE\n"; return false; }
+            opts.benchThreadsPath = argv[++i]; continue;
+        }
+        if (a == "--dump-grain") {
+            if (i + 1 >= argc) { std::cerr << "Error: --dump-grain FILE\n"; return false; }
+            opts.dumpGrainPath = argv[++i]; continue;
+        }
+        if (a == "--backend") {
+            if (i + 1 >= argc) { std::cerr << "Error: --backend requiere valor.\n"; return false; }
+            if (!parse_backend(argv[++i], opts.backend)) {
+                std::cerr << "Error: --backend {omp|pool|serial}\n"; return false;
+            }
+            continue;
+        }
+        if (a == "--bench-tasks") {
+            if (i + 1 >= argc) { std::cerr << "Error: --bench-tasks FILE\n"; return false; }
+            opts.benchTasksPath = argv[++i]; continue;
+        }
+        if (a == "--render") {
+            if (i + 1 >= argc) { std::cerr << "Error: --render requiere valor.\n"; return false; }
+            std::string r = argv[++i];
+            if      (r == "batch") opts.batchRain = true;
+            else if (r == "text")  opts.batchRain = false;
+            else { std::cerr << "Error: --render {batch|text}\n"; return false; }
+            continue;
+        }
+        if (a == "--kernel") {
+            if (i + 1 >= argc) { std::cerr << "Error: --kernel requiere valor.\n"; return false; }
+            std::string k = argv[++i];
+            if      (k == "auto")   opts.kernel = SimdKernel::Auto;
+            else if (k == "avx2")   opts.kernel = SimdKernel::Avx2;
+            else if (k == "sse")    opts.kernel = SimdKernel::Sse41;
+            else if (k == "scalar") opts.kernel = SimdKernel::Scalar;
+            else { std::cerr << "Error: --kernel {auto|avx2|sse|scalar}\n"; return false; }
+            continue;
+        }
+        if (a == "--seed") {
+            if (i + 1 >= argc) { std::cerr << "Error: --seed S\n"; return false; }
+            if (!parseSeed(argv[++i], opts.seed)) {
+                std::cerr << "Error: --seed entero >= 0 (decimal o 0x...)\n"; return false;
+            }
+            opts.seedSet = true; continue;
+        }
+        if (a == "--sim-hz") {
+            if (i + 1 >= argc) { std::cerr << "Error: --sim-hz H\n"; return false; }
+            float hz = std::atof(argv[++i]);
+            if (hz < 1.f || hz > 10000.f) { std::cerr << "Error: --sim-hz 1..10000\n"; return false; }
+            opts.simHz = hz; continue;
+        }
+        if (a == "--max-steps") {
+            if (i + 1 >= argc) { std::cerr << "Error: --max-steps K\n"; return false; }
+            int k = std::atoi(argv[++i]);
+            if (k <= 0 || k > 1000) { std::cerr << "Error: --max-steps 1..1000\n"; return false; }
+            opts.maxSteps = k; continue;
+        }
+        if (a == "--pin") {
+            if (i + 1 >= argc || !parsePinSpec(argv[i + 1], opts.pin)) {
+                std::cerr << "Error: --pin compact|scatter|none|LISTA (p.ej. 0,2,4-7)\n"; return false;
+            }
+            ++i; continue;
+        }
+        if (a == "--budget") {
+            if (i + 1 >= argc) { std::cerr << "Error: --budget MS\n"; return false; }
+            float ms = std::atof(argv[++i]);
+            if (ms < 0.f || ms > 1000.f) { std::cerr << "Error: --budget [0,1000] ms\n"; return false; }
+            opts.budgetMs = ms; continue;
+        }
+        if (a == "--bench-suite") {
+            if (i + 1 >= argc) { std::cerr << "Error: --bench-suite FILE\n"; return false; }
+            opts.benchSuitePath = argv[++i];
+            if (!file_exists(opts.benchSuitePath)) {
+                std::cerr << "Error: no existe " << opts.benchSuitePath << "\n"; return false;
+            }
+            continue;
+        }
+        if (a == "--bench-suite-out") {
+            if (i + 1 >= argc) { std::cerr << "Error: --bench-suite-out FILE\n"; return false; }
+            opts.benchSuiteOutPath = argv[++i]; continue;
+        }
+        if (a == "--dt") {
+            if (i + 1 >= argc) { std::cerr << "Error: --dt S\n"; return false; }
+            float dt = std::atof(argv[++i]);
+            if (dt <= 0.f || dt > 1.f) { std::cerr << "Error: --dt (0,1]\n"; return false; }
+            opts.fixedDt = dt; continue;
+        }
     }
     int pos = 0;
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
-        if (a == "--seq" || a == "--threads" || a == "--mode" || a == "--palette" || a == "--speed"
-            || a == "--bench" || a == "--bench-frames" || a == "-h" || a == "--help") {
-            if (a == "--threads" || a == "--mode" || a == "--palette" || a == "--speed"
-                || a == "--bench" || a == "--bench-frames") ++i;
+        if (is_option(a)) {
+            if (option_has_value(a)) ++i;
             continue;
         }
         if (pos < 2) {
@@ -140,6 +319,11 @@ static bool parse_cli(int argc, char** argv, CliOptions& opts) {
             ++pos;
         } else { std::cerr << "Demasiados posicionales.\n"; return false; }
     }
+    // Sin ventana no hay como cerrar: headless necesita un numero de frames
+    // (la suite lleva los suyos)
+    if (opts.headless && opts.benchFrames <= 0 && opts.benchSuitePath.empty()) {
+        std::cerr << "Error: --headless necesita --bench-frames K\n"; return false;
+    }
     if (1LL * opts.width * opts.height > 10000LL * 10000LL) { std::cerr << "Resolucion gigante.\n"; return false; }
     if (opts.nChars > opts.width * opts.height) {
         std::cerr << "Advertencia: N > pixeles; ajustando N.\n";
@@ -152,52 +336,633 @@ static bool parse_cli(int argc, char** argv, CliOptions& opts) {
     return true;
 }
 
-static int run_loop(const CliOptions& opts, bool vsync = true) {
+// -------------------- CSV de benchmark (comun a ventana y headless) --------------------
+// Las filas van a BenchLog: en el bucle solo se copia un BenchRecord al anillo;
+// el formato y la escritura los hace su hilo.
+static const char* const kBenchHeader =
+    "exec,mode,threads_req,threads_eff,width,height,N,speed,frame,dt_s,update_ms,render_ms,total_ms,fps,forkjoin_ms,stall_ms,sim_steps,work_ewma_ms,detail,threads_cap,budget_event,"
+    "busy_max_ms,busy_mean_ms,imbalance,barrier_ms,log_ms";
+
+static bool open_bench(const CliOptions& opts, const char* exec, int threads_req, int threads_eff,
+                       BenchLog& log) {
+    std::ostringstream prefix;
+    prefix << exec << ','
+           << mode_to_cstr(opts.mode) << ','
+           << threads_req << ','
+           << threads_eff << ','
+           << opts.width << ','
+           << opts.height << ','
+           << opts.nChars << ','
+           << std::fixed << std::setprecision(3) << opts.speed;
+    return log.open(opts.benchPath, kBenchHeader, prefix.str());
+}
+
+// Trabajo por hilo de los sitios de update que corrieron en el frame (ms),
+// sumado sobre sitios: el mayor de cada sitio, la media y la espera media en
+// la barrera de join. imbalance = max/media (1 = reparto perfecto)
+struct FrameThreadTimes {
+    double busyMax = 0.0, busyMean = 0.0, barrier = 0.0;
+    double imbalance() const { return busyMean > 0.0 ? busyMax / busyMean : 1.0; }
+};
+
+static void set_thread_times(BenchRecord& r, const FrameThreadTimes& tt) {
+    r.busy_max_ms = tt.busyMax;
+    r.busy_mean_ms = tt.busyMean;
+    r.imbalance = tt.imbalance();
+    r.barrier_ms = tt.barrier;
+}
+
+// Coste de registrar cada frame en el hilo del bucle (push de la fila y los
+// CSV por hilo, grano y tareas): va en log_ms del frame siguiente, fuera de total_ms
+struct LogCost {
+    double last = 0.0, sum = 0.0, max = 0.0;
+    int frames = 0;
+    void add(double ms) { last = ms; sum += ms; max = std::max(max, ms); ++frames; }
+};
+
+static void report_bench_log(const CliOptions& opts, BenchLog& log, const LogCost& cost) {
+    if (!log.isOpen()) return;
+    log.close();
+    std::cout << "[bench] " << log.rows() << " filas -> " << opts.benchPath
+              << "; registro en el bucle: media " << std::fixed << std::setprecision(2)
+              << (cost.frames ? 1000.0 * cost.sum / cost.frames : 0.0) << " us, max "
+              << 1000.0 * cost.max << " us; escritor " << std::setprecision(1) << log.writerMs()
+              << " ms en su hilo";
+    if (log.fullWaits()) std::cout << "; " << log.fullWaits() << " esperas por anillo lleno";
+    std::cout << '\n';
+}
+
+// -------------------- tiempos por hilo (--bench-threads) --------------------
+// Sitios que corrieron desde el frame anterior (cambio su contador de ejecuciones)
+struct SiteSeen {
+    std::array<std::uint64_t, int(ParSite::Count)> runs{};
+    std::array<bool, int(ParSite::Count)> ran{};
+};
+
+static void mark_sites_run(const TextRender& renderer, SiteSeen& seen) {
+    for (int s = 0; s < int(ParSite::Count); ++s) {
+        const std::uint64_t runs = renderer.siteRun(ParSite(s)).runs;
+        seen.ran[s] = runs != seen.runs[s];
+        seen.runs[s] = runs;
+    }
+}
+
+// Solo update: rain_fill es del render (con --pipeline, en paralelo a update)
+static FrameThreadTimes frame_thread_times(const TextRender& renderer, const SiteSeen& seen) {
+    FrameThreadTimes tt;
+    for (int s = 0; s < int(ParSite::Count); ++s) {
+        if (!seen.ran[s] || ParSite(s) == ParSite::RainFill) continue;
+        const std::vector<double>& busy = renderer.siteBusyMs(ParSite(s));
+        const std::vector<double>& wait = renderer.siteWaitMs(ParSite(s));
+        const int parts = std::min(renderer.siteRun(ParSite(s)).parts, (int)busy.size());
+        if (parts <= 0) continue;
+        double mx = 0.0, sum = 0.0, waitSum = 0.0;
+        for (int p = 0; p < parts; ++p) { mx = std::max(mx, busy[p]); sum += busy[p]; waitSum += wait[p]; }
+        tt.busyMax += mx;
+        tt.busyMean += sum / parts;
+        tt.barrier += waitSum / parts;
+    }
+    return tt;
+}
+
+static bool open_bench_threads(const CliOptions& opts, std::ofstream& out) {
     namespace fs = std::filesystem;
-    using clock_t = std::chrono::steady_clock;
+    bool newFile = !fs::exists(opts.benchThreadsPath);
+    out.open(opts.benchThreadsPath, std::ios::app);
+    if (!out) { std::cerr << "No pude abrir " << opts.benchThreadsPath << "\n"; return false; }
+    if (newFile) out << "exec,mode,threads_req,threads_eff,N,frame,site,parts,team,part,busy_ms,wait_ms\n";
+    return true;
+}
+
+// Una fila por parte de cada sitio que corrio en el frame (parte = hilo salvo
+// que el runtime de menos hilos que partes: ver team)
+static void write_thread_rows(std::ofstream& out, const CliOptions& opts, const char* exec,
+                              int threads_req, int threads_eff, int frame,
+                              const TextRender& renderer, const SiteSeen& seen) {
+    for (int s = 0; s < int(ParSite::Count); ++s) {
+        if (!seen.ran[s]) continue;
+        const std::vector<double>& busy = renderer.siteBusyMs(ParSite(s));
+        const std::vector<double>& wait = renderer.siteWaitMs(ParSite(s));
+        const int parts = renderer.siteRun(ParSite(s)).parts;
+        const int team = renderer.siteThreads(ParSite(s));
+        for (int p = 0; p < std::min(parts, (int)busy.size()); ++p)
+            out << exec << ',' << mode_to_cstr(opts.mode) << ',' << threads_req << ','
+                << threads_eff << ',' << opts.nChars << ',' << frame << ','
+                << parSiteName(ParSite(s)) << ',' << parts << ',' << team << ',' << p << ','
+                << std::fixed << std::setprecision(4) << busy[p] << ',' << wait[p] << '\n';
+    }
+}
+
+// -------------------- grafo de tareas (--taskgraph) --------------------
+static bool open_bench_tasks(const CliOptions& opts, std::ofstream& out) {
+    namespace fs = std::filesystem;
+    bool newFile = !fs::exists(opts.benchTasksPath);
+    out.open(opts.benchTasksPath, std::ios::app);
+    if (!out) { std::cerr << "No pude abrir " << opts.benchTasksPath << "\n"; return false; }
+    if (newFile) out << "mode,threads_eff,N,frame,task,deps,chunks,workers,start_ms,end_ms,busy_ms,critical\n";
+    return true;
+}
+
+// Una fila por tarea del ultimo update; deps separadas por '|'
+static void write_task_rows(std::ofstream& out, const CliOptions& opts, int threads_eff,
+                            int frame, const TaskGraph& g) {
+    for (int id = 0; id < g.size(); ++id) {
+        const TaskGraph::Stats& st = g.stats(id);
+        std::string deps;
+        for (int d : g.deps(id)) { if (!deps.empty()) deps += '|'; deps += g.name(d); }
+        out << mode_to_cstr(opts.mode) << ',' << threads_eff << ',' << opts.nChars << ','
+            << frame << ',' << g.name(id) << ',' << deps << ','
+            << st.chunks << ',' << st.workers << ','
+            << std::fixed << std::setprecision(4) << st.startMs << ',' << st.endMs << ','
+            << st.busyMs << ',' << (st.critical ? 1 : 0) << '\n';
+    }
+}
+
+// -------------------- politica de grano (--dump-grain) --------------------
+struct GrainDump {
+    std::ofstream out;
+    std::array<std::uint64_t, int(ParSite::Count)> runs{};  // ejecuciones ya volcadas
+};
+
+static bool open_dump_grain(const CliOptions& opts, GrainDump& dump) {
+    namespace fs = std::filesystem;
+    bool newFile = !fs::exists(opts.dumpGrainPath);
+    dump.out.open(opts.dumpGrainPath, std::ios::app);
+    if (!dump.out) { std::cerr << "No pude abrir " << opts.dumpGrainPath << "\n"; return false; }
+    if (newFile) dump.out << "mode,threads_eff,N,frame,site,trip,grain,parts,team,parallel,wall_ms,item_ns\n";
+    return true;
+}
+
+// Una fila por sitio que corrio desde la fila anterior (su ultima ejecucion).
+// item_ns = wall_ms * team / trip: con --backend serial, coste por elemento
+// para calibrar la tabla de TextRender.cpp
+static void write_grain_rows(GrainDump& dump, const CliOptions& opts, int threads_eff,
+                             int frame, const TextRender& renderer) {
+    for (int s = 0; s < int(ParSite::Count); ++s) {
+        const TextRender::SiteRun& r = renderer.siteRun(ParSite(s));
+        if (r.runs == dump.runs[s]) continue;
+        dump.runs[s] = r.runs;
+        const int team = renderer.siteThreads(ParSite(s));
+        const double itemNs = r.trip ? r.wallMs * 1e6 * team / double(r.trip) : 0.0;
+        dump.out << mode_to_cstr(opts.mode) << ',' << threads_eff << ',' << opts.nChars << ','
+                 << frame << ',' << parSiteName(ParSite(s)) << ',' << r.trip << ','
+                 << renderer.siteGrain(ParSite(s)) << ',' << r.parts << ',' << team << ','
+                 << (r.parts > 1 ? 1 : 0) << ','
+                 << std::fixed << std::setprecision(4) << r.wallMs << ','
+                 << std::setprecision(1) << itemNs << '\n';
+    }
+}
+
+// Media por tarea: duracion (fin - inicio) y fraccion de frames en la ruta critica
+struct TaskAcc {
+    std::vector<double> span;
+    std::vector<int> critical;
+    double makespan = 0.0, path = 0.0;
+    int frames = 0;
+};
+
+static void accumulate_tasks(const TaskGraph& g, TaskAcc& acc) {
+    acc.span.resize(g.size(), 0.0);
+    acc.critical.resize(g.size(), 0);
+    for (int id = 0; id < g.size(); ++id) {
+        acc.span[id] += g.stats(id).endMs - g.stats(id).startMs;
+        acc.critical[id] += g.stats(id).critical ? 1 : 0;
+    }
+    acc.makespan += g.makespanMs();
+    acc.path += g.criticalPathMs();
+    ++acc.frames;
+}
+
+static void report_tasks(const TaskGraph& g, const TaskAcc& acc) {
+    if (acc.frames == 0) return;
+    std::cout << "[graph] media por tarea (ms, % frames en ruta critica):";
+    for (int id = 0; id < g.size() && id < (int)acc.span.size(); ++id)
+        std::cout << ' ' << g.name(id) << '=' << std::fixed << std::setprecision(3)
+                  << acc.span[id] / acc.frames << " (" << std::setprecision(0)
+                  << 100.0 * acc.critical[id] / acc.frames << "%)";
+    std::cout << "\n[graph] makespan_ms=" << std::setprecision(3) << acc.makespan / acc.frames
+              << " ruta_critica_ms=" << acc.path / acc.frames << '\n';
+}
+
+// Configuracion de escena comun a todas las ejecuciones. --pipeline y
+// --sim-hz (interpolacion) dependen del bucle de frames: solo run_loop los
+// activa; la suite cambia ademas el backend por escena.
+static RenderConfig make_render_config(const CliOptions& opts, bool headless) {
+    RenderConfig cfg;
+    cfg.headless = headless;
+    cfg.batchRain = opts.batchRain;
+    cfg.kernel = opts.kernel;
+    cfg.collisions = opts.collisions;
+    cfg.seed = opts.seed;
+    cfg.taskGraph = opts.taskGraph;
+    cfg.backend = opts.backend;
+    cfg.pinCpus = pinOrder(opts.pin);
+    return cfg;
+}
+
+// Hilos que reparte el backend (el pool con --taskgraph: mismo tamano)
+static int effective_threads(const TextRender& renderer) {
+    return renderer.backend().threads();
+}
+
+// Hilos pedidos: --threads (o el elegido por --autotune), 1 con --seq y, sin
+// ninguno, los del runtime por defecto (los que reparte el backend)
+static int requested_threads(const CliOptions& opts, int threads_eff) {
+    if (opts.forceSequential) return 1;
+    return opts.threads > 0 ? opts.threads : threads_eff;
+}
+
+// Columna exec del CSV: graph con --taskgraph; si no, el backend (seq = serial)
+static const char* exec_label(const CliOptions& opts) {
+    return opts.taskGraph ? "graph" : backendName(opts.backend);
+}
+
+// --pin: CPUs por ranura y cuantos hilos quedaron fijados
+static void report_pin(const CliOptions& opts, const TextRender& renderer, int threads_eff) {
+    if (opts.pin.mode == PinMode::None) return;
+    const std::vector<int> cpus = pinOrder(opts.pin);
+    std::cout << "[pin] " << pinModeName(opts.pin.mode) << ":";
+    for (int t = 0; t < std::min<int>(threads_eff, int(cpus.size())); ++t)
+        std::cout << (t ? "," : " ") << cpus[t];
+    if (int(cpus.size()) < threads_eff) std::cout << " (" << threads_eff << " hilos en " << cpus.size() << " CPUs)";
+    std::cout << " -> " << renderer.pinnedThreads() << '/' << threads_eff << " hilos fijados\n";
+    if (cpus.empty()) std::cerr << "Advertencia: --pin sin CPUs permitidas; los hilos quedan sin fijar\n";
+}
+
+// Auto-chequeo: hilos que obtuvo realmente cada region de update en el primer
+// frame. Las que la politica de grano deja en el llamador salen como "=1 (grano)"
+// y no cuentan como degradadas.
+static void report_site_threads(const TextRender& renderer, int requested) {
+    bool degraded = false;
+    std::cout << "[omp] hilos por fase (pedidos " << requested << "):";
+    for (int s = 0; s < int(ParSite::Count); ++s) {
+        int t = renderer.siteThreads(ParSite(s));
+        if (t == 0) continue; // fase no usada en este modo
+        const int parts = renderer.siteRun(ParSite(s)).parts;
+        std::cout << ' ' << parSiteName(ParSite(s)) << '=' << t;
+        if (parts < requested) std::cout << " (grano)";
+        if (t < parts) degraded = true;
+    }
+    std::cout << '\n';
+    if (renderer.kernelKind() != SimdKernel::Scalar)
+        std::cout << "[simd] kernel de particulas: " << simdKernelName(renderer.kernelKind()) << '\n';
+    if (degraded)
+        std::cerr << "[omp] Aviso: alguna fase corrio con menos hilos de los pedidos "
+                     "(region anidada, OMP_DYNAMIC o limite del runtime).\n";
+}
+
+// Desbalance por fase: media por frame de max/media del tiempo de trabajo por hilo
+// (solo fases que miden su tiempo por hilo, ver TextRender::siteBusyMs)
+struct ImbalanceAcc {
+    std::array<double, int(ParSite::Count)> sum{};
+    std::array<double, int(ParSite::Count)> wait{};
+    std::array<int, int(ParSite::Count)> frames{};
+};
+
+// Sitios que corrieron en el frame repartidos en 2 o mas partes
+static void accumulate_imbalance(const TextRender& renderer, const SiteSeen& seen, ImbalanceAcc& acc) {
+    for (int s = 0; s < int(ParSite::Count); ++s) {
+        const int parts = renderer.siteRun(ParSite(s)).parts;
+        const std::vector<double>& busy = renderer.siteBusyMs(ParSite(s));
+        const std::vector<double>& wait = renderer.siteWaitMs(ParSite(s));
+        if (!seen.ran[s] || parts < 2 || parts > (int)busy.size()) continue;
+        double mx = 0.0, sum = 0.0, waitSum = 0.0;
+        for (int p = 0; p < parts; ++p) { mx = std::max(mx, busy[p]); sum += busy[p]; waitSum += wait[p]; }
+        if (sum <= 0.0) continue;
+        acc.sum[s] += mx / (sum / parts);
+        acc.wait[s] += waitSum / parts;
+        ++acc.frames[s];
+    }
+}
+
+static void report_imbalance(const ImbalanceAcc& acc) {
+    bool any = false;
+    for (int s = 0; s < int(ParSite::Count); ++s) {
+        if (acc.frames[s] == 0) continue;
+        if (!any) std::cout << "[omp] desbalance max/media por fase:";
+        any = true;
+        std::cout << ' ' << parSiteName(ParSite(s)) << '='
+                  << std::fixed << std::setprecision(2) << acc.sum[s] / acc.frames[s];
+    }
+    if (!any) return;
+    std::cout << "\n[omp] espera media en la barrera por fase (ms):";
+    for (int s = 0; s < int(ParSite::Count); ++s)
+        if (acc.frames[s] > 0)
+            std::cout << ' ' << parSiteName(ParSite(s)) << '='
+                      << std::setprecision(4) << acc.wait[s] / acc.frames[s];
+    std::cout << '\n';
+}
+
+// -------------------- desglose de arranque --------------------
+static std::chrono::steady_clock::time_point g_processStart;
+
+static double ms_between(std::chrono::steady_clock::time_point a,
+                         std::chrono::steady_clock::time_point b) {
+    return std::chrono::duration<double, std::milli>(b - a).count();
+}
+
+struct StartupTimes {
+    double window_ms = 0.0;  // crear ventana/contexto (0 en headless)
+    double font_ms   = 0.0;
+    double obj_ms    = 0.0;  // incluido en el constructor de TextRender
+    double scene_ms  = 0.0;  // constructor de TextRender sin el OBJ
+    double first_ms  = 0.0;  // desde el inicio de main hasta el primer frame
+};
+
+static void report_startup(const StartupTimes& s) {
+    std::cout << std::fixed << std::setprecision(1)
+              << "[startup] window_ms=" << s.window_ms
+              << " font_ms=" << s.font_ms
+              << " obj_ms=" << s.obj_ms
+              << " scene_ms=" << s.scene_ms
+              << " first_frame_ms=" << s.first_ms << '\n';
+}
+
+// -------------------- pipeline update/render --------------------
+// Hilo de simulacion de --pipeline. kick(dt, steps) lanza steps updates sobre
+// el estado trasero mientras el hilo principal dibuja la vista publicada;
+// wait() bloquea hasta que terminan y devuelve el tiempo bloqueado (stall, ms).
+// El ctor vuelve cuando el hilo ya fijo sus CPUs: ningun render ni kick
+// coincide con el pinning.
+class SimWorker {
+public:
+    SimWorker(TextRender& renderer, int threads)
+        : renderer_(renderer), thread_([this, threads] { loop(threads); }) {
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [this] { return ready_; });
+    }
+
+    ~SimWorker() {
+        { std::lock_guard<std::mutex> lk(m_); quit_ = true; }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    void kick(float dt, int steps) {
+        { std::lock_guard<std::mutex> lk(m_); dt_ = dt; steps_ = steps; pending_ = true; }
+        cv_.notify_all();
+    }
+
+    double wait() {
+        const auto t0 = std::chrono::steady_clock::now();
+        std::unique_lock<std::mutex> lk(m_);
+        cv_.wait(lk, [this] { return !pending_; });
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    // Suma de los updates del ultimo kick y de su fork/join (validas tras wait)
+    double updateMs() const { return updateMs_; }
+    double forkJoinMs() const { return forkJoinMs_; }
+
+private:
+    void loop(int threads) {
+#ifdef _OPENMP
+        // Las ICV de OpenMP son por hilo: este no hereda omp_set_num_threads de main
+        omp_set_num_threads(threads);
+#endif
+        // --pin: su equipo tambien (las CPUs desde la segunda: la primera es
+        // la del hilo de render)
+        renderer_.pinThreads(1);
+        std::unique_lock<std::mutex> lk(m_);
+        ready_ = true;
+        cv_.notify_all();
+        for (;;) {
+            cv_.wait(lk, [this] { return pending_ || quit_; });
+            if (quit_) return;
+            const float dt = dt_;
+            const int steps = steps_;
+            lk.unlock();
+            double fj = 0.0;
+            const auto t0 = std::chrono::steady_clock::now();
+            for (int s = 0; s < steps; ++s) {
+                renderer_.update(dt);
+                fj += renderer_.forkJoinMs();
+            }
+            const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+            lk.lock();
+            updateMs_ = ms;
+            forkJoinMs_ = fj;
+            pending_ = false;
+            cv_.notify_all();
+        }
+    }
+
+    TextRender& renderer_;
+    std::mutex m_;
+    std::condition_variable cv_;
+    float  dt_ = 0.f;
+    int    steps_ = 0;
+    bool   pending_ = false;
+    bool   quit_ = false;
+    bool   ready_ = false;   // el hilo ya fijo sus CPUs
+    double updateMs_ = 0.0;
+    double forkJoinMs_ = 0.0;
+    std::thread thread_;   // ultimo: arranca con el resto ya inicializado
+};
+
+// -------------------- paso fijo --------------------
+// Acumula el tiempo real y lo consume en pasos de h. Un frame lento no dispara
+// mas de maxSteps pasos: la deuda sobrante se descarta (la simulacion se atrasa
+// respecto al reloj en vez de entrar en una espiral de pasos cada vez mas caros).
+struct FixedStep {
+    double h = 0.0;
+    int    maxSteps = 5;
+    double acc = 0.0;
+    long long dropped = 0;   // pasos descartados por el tope
+
+    int plan(float frameDt) {
+        acc += frameDt;
+        const long long due = (long long)std::floor(acc / h);
+        acc -= double(due) * h;
+        const int steps = int(std::min<long long>(due, maxSteps));
+        dropped += due - steps;
+        return steps;
+    }
+    // Fraccion del paso siguiente ya transcurrida: peso del ultimo paso al dibujar
+    float alpha() const { return float(acc / h); }
+};
+
+// -------------------- presupuesto de frame (--budget) --------------------
+// Controlador con histeresis sobre la media movil (EWMA) del trabajo del frame:
+// update + dibujo, sin la espera de display/vsync (con --pipeline, el mayor de
+// los dos). Si pasa del objetivo kOverFrames seguidos baja el detalle (fraccion
+// de particulas activas o de columnas de lluvia dibujadas); si queda por debajo
+// de kLowFrac del objetivo kUnderFrames seguidos lo sube. Los cambios de hilos
+// son pruebas: tras kCooldown frames se comparan con la media previa y, si no
+// ayudan, se revierten y no se repiten en kBackoff frames. Tras cada cambio se
+// espera kCooldown frames antes de decidir otra cosa.
+struct FrameBudget {
+    static constexpr double kAlpha    = 0.1;
+    static constexpr double kLowFrac  = 0.7;
+    static constexpr double kGain     = 0.95;  // mas hilos: al menos un 5% mejor
+    static constexpr int    kOverFrames  = 10;
+    static constexpr int    kUnderFrames = 60;
+    static constexpr int    kCooldown    = 30;
+    static constexpr int    kBackoff     = 600;
+    static constexpr float  kStep  = 0.1f;
+    static constexpr float  kFloor = 0.1f;
+
+    double target = 0.0;
+    double ewma = 0.0;
+    float detail = 1.f;
+    int threads = 1, maxThreads = 1;
+    bool fixedThreads = false; // --taskgraph: el pool no usa el tope de partes
+    const char* event = "-";   // decision de este frame (columna budget_event)
+
+    // Devuelve true si cambio detail o threads (aplicar entre frames)
+    bool observe(double work_ms) {
+        event = "-";
+        ewma = (samples++ == 0) ? work_ms : ewma + kAlpha * (work_ms - ewma);
+        if (backoffUp > 0) --backoffUp;
+        if (backoffDown > 0) --backoffDown;
+        if (cooldown > 0) { --cooldown; if (cooldown == 0 && trialFrom) return endTrial(); return false; }
+
+        over  = ewma > target ? over + 1 : 0;
+        under = ewma < kLowFrac * target ? under + 1 : 0;
+        if (over >= kOverFrames) {
+            if (!fixedThreads && threads < maxThreads && backoffUp == 0)
+                return startTrial(std::min(maxThreads, threads * 2), "threads+");
+            if (detail > kFloor) return setDetail(std::max(kFloor, detail - kStep), "detail-");
+            if (!fixedThreads && threads > 1 && backoffDown == 0)
+                return startTrial(threads / 2, "threads-");
+        } else if (under >= kUnderFrames) {
+            if (detail < 1.f) return setDetail(std::min(1.f, detail + kStep), "detail+");
+            // Holgura con todo el detalle: menos hilos si siguen cabiendo
+            if (!fixedThreads && threads > 1 && backoffDown == 0) return startTrial(threads / 2, "threads-");
+        }
+        return false;
+    }
+
+private:
+    long long samples = 0;
+    int over = 0, under = 0, cooldown = 0;
+    int backoffUp = 0, backoffDown = 0;
+    int trialFrom = 0;         // hilos antes de la prueba (0 = sin prueba)
+    double trialBase = 0.0;    // EWMA antes de la prueba
+
+    void settle() { over = under = 0; cooldown = kCooldown; }
 
-    // Solicitar z-buffer
+    bool setDetail(float d, const char* ev) {
+        detail = d;
+        event = ev;
+        settle();
+        return true;
+    }
+    bool startTrial(int t, const char* ev) {
+        trialFrom = threads;
+        trialBase = ewma;
+        threads = t;
+        event = ev;
+        settle();
+        return true;
+    }
+    // Mas hilos: se quedan si mejoran la media. Menos hilos: si no empeoran
+    // (mismo tiempo con nucleos libres) o, por encima del objetivo, si mejoran
+    bool endTrial() {
+        const bool up = threads > trialFrom;
+        const bool keep = up ? ewma < kGain * trialBase
+                             : (ewma <= trialBase || ewma < kLowFrac * target);
+        if (keep) { trialFrom = 0; event = "threads-keep"; return false; }
+        (up ? backoffUp : backoffDown) = kBackoff;
+        threads = trialFrom;
+        trialFrom = 0;
+        event = "threads-revert";
+        settle();
+        return true;
+    }
+};
+
+// Contexto de las ventanas: con z-buffer
+static sf::ContextSettings window_context() {
     sf::ContextSettings ctx;
     ctx.depthBits = 24;
     ctx.stencilBits = 0;
     ctx.antialiasingLevel = 0;
     ctx.majorVersion = 2;
     ctx.minorVersion = 1;
+    return ctx;
+}
+
+static int run_loop(const CliOptions& opts, bool vsync = true) {
+    using clock_t = std::chrono::steady_clock;
 
+    StartupTimes startup;
+    auto tPhase = clock_t::now();
     sf::RenderWindow window(sf::VideoMode(opts.width, opts.height),
                             "Matrix N caracteres",
                             sf::Style::Default,
-                            ctx);
+                            window_context());
     if (vsync) window.setVerticalSyncEnabled(true);
     else window.setFramerateLimit(60);
+    startup.window_ms = ms_between(tPhase, clock_t::now());
 
+    tPhase = clock_t::now();
     sf::Font font;
     if (!font.loadFromFile("assets/fonts/Matrix-MZ4P.ttf")) {
         std::cerr << "Error cargando fuente.\n";
         return EXIT_FAILURE;
     }
+    startup.font_ms = ms_between(tPhase, clock_t::now());
 
+    RenderConfig cfg = make_render_config(opts, false);
+    cfg.pipelined = opts.pipeline;
+    cfg.interpolate = opts.simHz > 0.f;
+    tPhase = clock_t::now();
     TextRender renderer(opts.nChars, font, 24, window.getSize(),
-                        opts.mode, opts.speed, opts.palette);
+                        opts.mode, opts.speed, opts.palette, cfg);
+    startup.obj_ms = renderer.objLoadMs();
+    startup.scene_ms = ms_between(tPhase, clock_t::now()) - startup.obj_ms;
 
-    #ifdef _OPENMP
-        int threads_eff = omp_get_max_threads();
-    #else
-        int threads_eff = 1;
-    #endif
-    const char* exec = opts.forceSequential ? "seq" : "omp";
+    const int threads_eff = effective_threads(renderer);
+    const int threads_req = requested_threads(opts, threads_eff);
+    const char* exec = exec_label(opts);
+    report_pin(opts, renderer, threads_eff);
 
-    std::ofstream benchOut;
+    BenchLog benchLog;
     const bool benchEnabled = !opts.benchPath.empty();
-    if (benchEnabled) {
-        bool newFile = !fs::exists(opts.benchPath);
-        benchOut.open(opts.benchPath, std::ios::app);
-        if (!benchOut) { std::cerr << "No pude abrir " << opts.benchPath << "\n"; return EXIT_FAILURE; }
-        if (newFile) benchOut << "exec,mode,threads_req,threads_eff,width,height,N,speed,frame,dt_s,update_ms,render_ms,total_ms,fps\n";
+    if (benchEnabled && !open_bench(opts, exec, threads_req, threads_eff, benchLog)) return EXIT_FAILURE;
+    LogCost logCost;
+
+    const TaskGraph* graph = renderer.taskGraph();
+    std::ofstream tasksOut;
+    const bool tasksEnabled = graph && !opts.benchTasksPath.empty();
+    if (tasksEnabled && !open_bench_tasks(opts, tasksOut)) return EXIT_FAILURE;
+    if (graph) std::cout << "[graph] tareas: " << graph->describe() << '\n';
+    TaskAcc taskAcc;
+
+    GrainDump grainDump;
+    const bool grainEnabled = !opts.dumpGrainPath.empty();
+    if (grainEnabled && !open_dump_grain(opts, grainDump)) return EXIT_FAILURE;
+
+    std::ofstream threadsOut;
+    const bool threadsEnabled = !opts.benchThreadsPath.empty();
+    if (threadsEnabled && !open_bench_threads(opts, threadsOut)) return EXIT_FAILURE;
+    SiteSeen seen;
+
+    // Con pipeline el frame 0 dibuja el estado inicial mientras se simula el 1
+    std::unique_ptr<SimWorker> pipe;
+    if (opts.pipeline) pipe = std::make_unique<SimWorker>(renderer, threads_eff);
+
+    const bool fixedStep = opts.simHz > 0.f;
+    FixedStep stepper;
+    if (fixedStep) {
+        stepper.h = 1.0 / opts.simHz;
+        stepper.maxSteps = opts.maxSteps;
     }
+    float drawAlpha = 1.f;   // alpha del estado que se dibuja (con pipeline, el publicado)
+
+    const bool budgetEnabled = opts.budgetMs > 0.f;
+    FrameBudget budget;
+    budget.target = opts.budgetMs;
+    budget.threads = budget.maxThreads = threads_eff;
+    budget.fixedThreads = opts.taskGraph;
+    if (budgetEnabled)
+        std::cout << "[budget] objetivo " << opts.budgetMs << " ms (update + dibujo), hasta "
+                  << threads_eff << " hilos\n";
 
     sf::Clock dtClock;
     int frame = 0;
+    ImbalanceAcc imbalance;
 
     while (window.isOpen()) {
         sf::Event e;
@@ -213,86 +978,652 @@ static int run_loop(const CliOptions& opts, bool vsync = true) {
 
         float dt = dtClock.restart().asSeconds();
 
+        // Paso fijo: 0..maxSteps pasos de h; si no, un paso con el dt del reloj
+        const int steps = fixedStep ? stepper.plan(dt) : 1;
+        const float stepDt = fixedStep ? float(stepper.h) : dt;
+
+        double update_ms, render_ms, draw_ms, stall_ms = 0.0, forkjoin_ms = 0.0;
         auto t0 = clock_t::now();
-        renderer.update(dt);
-        auto t1 = clock_t::now();
+        auto t2 = t0;
+        if (pipe) {
+            // update(N+1) en el hilo de simulacion || render(N) aqui; stall =
+            // espera al update tras dibujar. Ideal: total ~ max(update, render)
+            pipe->kick(stepDt, steps);
+            window.clear(sf::Color::Black);
+            renderer.render(window, drawAlpha);
+            const auto tDraw = clock_t::now();
+            window.display();
+            auto t1 = clock_t::now();
+            stall_ms = pipe->wait();
+            renderer.publishFrame();
+            if (fixedStep) drawAlpha = stepper.alpha();
+            t2 = clock_t::now();
+            update_ms = pipe->updateMs();
+            forkjoin_ms = pipe->forkJoinMs();
+            render_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            draw_ms = std::chrono::duration<double, std::milli>(tDraw - t0).count();
+            if (frame == 0) report_site_threads(renderer, threads_eff);
+        } else {
+            for (int s = 0; s < steps; ++s) {
+                renderer.update(stepDt);
+                forkjoin_ms += renderer.forkJoinMs();
+            }
+            auto t1 = clock_t::now();
+            if (frame == 0) report_site_threads(renderer, threads_eff);
+            if (fixedStep) drawAlpha = stepper.alpha();
 
-        window.clear(sf::Color::Black);
-        renderer.render(window);
-        window.display();
+            window.clear(sf::Color::Black);
+            renderer.render(window, drawAlpha);
+            const auto tDraw = clock_t::now();
+            window.display();
 
-        auto t2 = clock_t::now();
+            t2 = clock_t::now();
+            update_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+            render_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
+            draw_ms = std::chrono::duration<double, std::milli>(tDraw - t1).count();
+        }
+        if (frame == 0) {
+            startup.first_ms = ms_between(g_processStart, t2);
+            report_startup(startup);
+        }
 
-        double update_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
-        double render_ms = std::chrono::duration<double, std::milli>(t2 - t1).count();
         double total_ms  = std::chrono::duration<double, std::milli>(t2 - t0).count();
         double fps       = (dt > 0.0f) ? (1.0 / dt) : 0.0;
 
+        // Fuera de update/render (con pipeline, el hilo de simulacion ya espero)
+        if (budgetEnabled) {
+            const double work_ms = pipe ? std::max(update_ms, draw_ms) : update_ms + draw_ms;
+            if (budget.observe(work_ms)) {
+                renderer.setDetail(budget.detail);
+                renderer.setThreadCap(budget.threads);
+                std::cout << "[budget] frame " << frame << ' ' << budget.event << ": media "
+                          << std::fixed << std::setprecision(2) << budget.ewma << " ms, detalle "
+                          << budget.detail << ", hilos " << budget.threads << '\n';
+            }
+        }
+
+        const auto tLog = clock_t::now();
+        mark_sites_run(renderer, seen);
         if (benchEnabled) {
-            benchOut    << exec << ','
-                        << mode_to_cstr(opts.mode) << ','
-                        << 0 << ','
-                        << threads_eff << ','
-                        << opts.width << ','
-                        << opts.height << ','
-                        << opts.nChars << ','
-                        << std::fixed << std::setprecision(3) << opts.speed << ','
-                        << frame << ','
-                        << std::setprecision(6) << dt << ','
-                        << std::setprecision(3) << update_ms << ','
-                        << render_ms << ','
-                        << total_ms << ','
-                        << std::setprecision(2) << fps
-                        << '\n';
+            BenchRecord r;
+            r.frame = frame;
+            r.dt = dt;
+            r.update_ms = update_ms;
+            r.render_ms = render_ms;
+            r.total_ms = total_ms;
+            r.fps = fps;
+            r.forkjoin_ms = forkjoin_ms;
+            r.stall_ms = stall_ms;
+            r.sim_steps = steps;
+            r.work_ewma_ms = budget.ewma;
+            r.detail = renderer.detail();
+            r.threads_cap = budget.threads;
+            r.budget_event = budget.event;
+            set_thread_times(r, frame_thread_times(renderer, seen));
+            r.log_ms = logCost.last;
+            benchLog.push(r);
         }
+        if (threadsEnabled)
+            write_thread_rows(threadsOut, opts, exec, threads_req, threads_eff, frame, renderer, seen);
+        if (grainEnabled) write_grain_rows(grainDump, opts, threads_eff, frame, renderer);
+        if (frame > 0) accumulate_imbalance(renderer, seen, imbalance);
+        if (graph && steps > 0) {
+            if (tasksEnabled) write_task_rows(tasksOut, opts, threads_eff, frame, *graph);
+            if (frame > 0) accumulate_tasks(*graph, taskAcc);
+        }
+        logCost.add(std::chrono::duration<double, std::milli>(clock_t::now() - tLog).count());
 
         ++frame;
         if (opts.benchFrames > 0 && frame >= opts.benchFrames) window.close();
     }
+    report_imbalance(imbalance);
+    if (graph) report_tasks(*graph, taskAcc);
+    if (fixedStep)
+        std::cout << "[step] " << opts.simHz << " Hz, pasos descartados por --max-steps: "
+                  << stepper.dropped << '\n';
 
-    if (benchEnabled) benchOut.close();
+    report_bench_log(opts, benchLog, logCost);
     return EXIT_SUCCESS;
 }
 
-static int run_sequential(const CliOptions& opts) { return run_loop(opts); }
+// Solo simulacion: dt fijo, sin ventana, sin contexto GL ni vsync.
+// Mismo CSV que --bench con render_ms = 0 y fps derivado del tiempo de update.
+static int run_headless(const CliOptions& opts) {
+    using clock_t = std::chrono::steady_clock;
+
+    StartupTimes startup;
+    auto tPhase = clock_t::now();
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/Matrix-MZ4P.ttf")) {
+        std::cerr << "Error cargando fuente.\n";
+        return EXIT_FAILURE;
+    }
+    startup.font_ms = ms_between(tPhase, clock_t::now());
 
-static int run_parallel(const CliOptions& opts) {
-#ifdef _OPENMP
-    if (opts.threads > 0) omp_set_num_threads(opts.threads);
+    if (opts.pipeline) std::cout << "[pipeline] sin efecto con --headless (no hay render)\n";
+
+    const RenderConfig cfg = make_render_config(opts, true);
+    tPhase = clock_t::now();
+    TextRender renderer(opts.nChars, font, 24,
+                        sf::Vector2u(unsigned(opts.width), unsigned(opts.height)),
+                        opts.mode, opts.speed, opts.palette, cfg);
+    startup.obj_ms = renderer.objLoadMs();
+    startup.scene_ms = ms_between(tPhase, clock_t::now()) - startup.obj_ms;
 
-    // Mensaje de arranque en región paralela
-    #pragma omp parallel
-    {
-        #pragma omp single
-        {
-            std::cout << "Iniciando ejecucion paralela con "
-                      << omp_get_num_threads() << " hilos.\n";
+    const int threads_eff = effective_threads(renderer);
+    const int threads_req = requested_threads(opts, threads_eff);
+    const char* exec = exec_label(opts);
+    report_pin(opts, renderer, threads_eff);
+
+    BenchLog benchLog;
+    const bool benchEnabled = !opts.benchPath.empty();
+    if (benchEnabled && !open_bench(opts, exec, threads_req, threads_eff, benchLog)) return EXIT_FAILURE;
+    LogCost logCost;
+
+    const TaskGraph* graph = renderer.taskGraph();
+    std::ofstream tasksOut;
+    const bool tasksEnabled = graph && !opts.benchTasksPath.empty();
+    if (tasksEnabled && !open_bench_tasks(opts, tasksOut)) return EXIT_FAILURE;
+    if (graph) std::cout << "[graph] tareas: " << graph->describe() << '\n';
+    TaskAcc taskAcc;
+
+    GrainDump grainDump;
+    const bool grainEnabled = !opts.dumpGrainPath.empty();
+    if (grainEnabled && !open_dump_grain(opts, grainDump)) return EXIT_FAILURE;
+
+    std::ofstream threadsOut;
+    const bool threadsEnabled = !opts.benchThreadsPath.empty();
+    if (threadsEnabled && !open_bench_threads(opts, threadsOut)) return EXIT_FAILURE;
+    SiteSeen seen;
+
+    // Headless ya usa paso fijo: --sim-hz H equivale a --dt 1/H
+    const float dt = opts.simHz > 0.f ? 1.f / opts.simHz : opts.fixedDt;
+    double sum_update = 0.0, sum_forkjoin = 0.0;
+    int frame = 0;
+    ImbalanceAcc imbalance;
+    for (; frame < opts.benchFrames; ++frame) {
+        auto t0 = clock_t::now();
+        renderer.update(dt);
+        auto t1 = clock_t::now();
+        if (frame == 0) {
+            startup.first_ms = ms_between(g_processStart, t1);
+            report_startup(startup);
+            report_site_threads(renderer, threads_eff);
         }
+
+        double update_ms = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        double fps       = (update_ms > 0.0) ? (1000.0 / update_ms) : 0.0;
+        sum_update += update_ms;
+        sum_forkjoin += renderer.forkJoinMs();
+
+        const auto tLog = clock_t::now();
+        mark_sites_run(renderer, seen);
+        if (benchEnabled) {
+            BenchRecord r;
+            r.frame = frame;
+            r.dt = dt;
+            r.update_ms = update_ms;
+            r.total_ms = update_ms;
+            r.fps = fps;
+            r.forkjoin_ms = renderer.forkJoinMs();
+            r.sim_steps = 1;
+            r.detail = renderer.detail();
+            r.threads_cap = threads_eff;
+            set_thread_times(r, frame_thread_times(renderer, seen));
+            r.log_ms = logCost.last;
+            benchLog.push(r);
+        }
+        if (threadsEnabled)
+            write_thread_rows(threadsOut, opts, exec, threads_req, threads_eff, frame, renderer, seen);
+        if (grainEnabled) write_grain_rows(grainDump, opts, threads_eff, frame, renderer);
+        if (frame > 0) accumulate_imbalance(renderer, seen, imbalance);
+        if (graph) {
+            if (tasksEnabled) write_task_rows(tasksOut, opts, threads_eff, frame, *graph);
+            if (frame > 0) accumulate_tasks(*graph, taskAcc);
+        }
+        logCost.add(std::chrono::duration<double, std::milli>(clock_t::now() - tLog).count());
+    }
+    report_imbalance(imbalance);
+    if (graph) report_tasks(*graph, taskAcc);
+
+    std::cout << "[headless] " << mode_to_cstr(opts.mode) << " N=" << opts.nChars
+              << " frames=" << frame << " update_ms_avg="
+              << std::fixed << std::setprecision(3) << (frame ? sum_update / frame : 0.0)
+              << " forkjoin_ms_avg=" << std::setprecision(4) << (frame ? sum_forkjoin / frame : 0.0)
+              << " state_hash=" << std::hex << renderer.stateHash() << std::dec << "\n";
+    report_bench_log(opts, benchLog, logCost);
+    return EXIT_SUCCESS;
+}
+
+static int run_frames(const CliOptions& opts) {
+    return opts.headless ? run_headless(opts) : run_loop(opts);
+}
+
+// -------------------- autotune (--autotune) --------------------
+// Barrido de hilos sobre TextRender::update en headless con la misma escena
+// (modo, N, resolucion, semilla, kernel, backend): se queda con la mediana mas
+// baja. La cache guarda una fila por CPU + configuracion; si hay fila, no se mide.
+static constexpr int kTuneWarmup = 3;
+static constexpr int kTuneFrames = 15;
+// Mas hilos solo si bajan la mediana al menos un 3% (si no, ruido: menos
+// hilos dejan nucleos libres para el render y el resto del sistema)
+static constexpr double kTuneMinGain = 0.97;
+
+static std::string cpu_model() {
+    std::ifstream in("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.rfind("model name", 0) != 0) continue;
+        std::string name = line.substr(line.find(':') + 1);
+        name.erase(0, name.find_first_not_of(" \t"));
+        std::replace(name.begin(), name.end(), ',', ' ');  // columna CSV
+        return name;
     }
+    return "unknown";
+}
+
+// Clave sin la CPU: lo que cambia el coste de update
+static std::string tune_key(const CliOptions& opts) {
+    std::ostringstream k;
+    k << mode_to_cstr(opts.mode) << (opts.collisions ? "+collide" : "") << ','
+      << opts.nChars << ',' << opts.width << ',' << opts.height << ','
+      << (opts.taskGraph ? "graph" : backendName(opts.backend)) << ','
+      << simdKernelName(opts.kernel);
+    return k.str();
+}
+
+static int read_tune_cache(const CliOptions& opts, const std::string& cpu, int cores) {
+    std::ifstream in(opts.autotuneCache);
+    const std::string prefix = cpu + ',' + std::to_string(cores) + ',' + tune_key(opts) + ',';
+    std::string line;
+    int threads = 0;
+    while (std::getline(in, line))   // la ultima fila que coincida gana
+        if (line.rfind(prefix, 0) == 0) threads = std::atoi(line.c_str() + prefix.size());
+    return threads;
+}
+
+static void write_tune_cache(const CliOptions& opts, const std::string& cpu, int cores,
+                             int threads, double update_ms) {
+    namespace fs = std::filesystem;
+    bool newFile = !fs::exists(opts.autotuneCache);
+    std::ofstream out(opts.autotuneCache, std::ios::app);
+    if (!out) { std::cerr << "No pude abrir " << opts.autotuneCache << "\n"; return; }
+    if (newFile) out << "cpu,cores,mode,N,width,height,exec,kernel,threads,update_ms\n";
+    out << cpu << ',' << cores << ',' << tune_key(opts) << ',' << threads << ','
+        << std::fixed << std::setprecision(3) << update_ms << '\n';
+}
+
+// Mediana de update (ms) con t hilos
+static double measure_update(const CliOptions& opts, const sf::Font& font, int t) {
+#ifdef _OPENMP
+    omp_set_num_threads(t);
 #endif
+    const RenderConfig cfg = make_render_config(opts, true);
+    TextRender renderer(opts.nChars, font, 24,
+                        sf::Vector2u(unsigned(opts.width), unsigned(opts.height)),
+                        opts.mode, opts.speed, opts.palette, cfg);
+    std::vector<double> ms;
+    for (int f = 0; f < kTuneWarmup + kTuneFrames; ++f) {
+        const auto t0 = std::chrono::steady_clock::now();
+        renderer.update(opts.fixedDt);
+        const double m = std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - t0).count();
+        if (f >= kTuneWarmup) ms.push_back(m);
+    }
+    std::nth_element(ms.begin(), ms.begin() + ms.size() / 2, ms.end());
+    return ms[ms.size() / 2];
+}
+
+// Hilos elegidos (0 = sin cambio). Candidatos: 1, 2, 4, ... y el maximo
+// (--threads si se dio; si no, los nucleos logicos).
+static int autotune_threads(const CliOptions& opts) {
+    const int cores = std::max(1, int(std::thread::hardware_concurrency()));
+    const std::string cpu = cpu_model();
+    if (!opts.autotuneCache.empty()) {
+        const int cached = read_tune_cache(opts, cpu, cores);
+        if (cached > 0) {
+            std::cout << "[autotune] cache " << opts.autotuneCache << ": " << cached << " hilos\n";
+            return cached;
+        }
+    }
+    if (opts.backend == Backend::Serial && !opts.taskGraph) {
+        std::cout << "[autotune] backend serial: nada que ajustar\n";
+        return 0;
+    }
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/Matrix-MZ4P.ttf")) return 0;
+
+    const int maxT = opts.threads > 0 ? opts.threads : cores;
+    std::vector<int> candidates;
+    for (int t = 1; t < maxT; t *= 2) candidates.push_back(t);
+    candidates.push_back(maxT);
+
+    int best = 0;
+    double bestMs = 0.0;
+    std::cout << "[autotune] " << tune_key(opts) << " update_ms (mediana):";
+    for (int t : candidates) {
+        const double m = measure_update(opts, font, t);
+        std::cout << ' ' << t << '=' << std::fixed << std::setprecision(3) << m;
+        if (best == 0 || m < bestMs * kTuneMinGain) { best = t; bestMs = m; }
+    }
+    std::cout << " -> " << best << " hilos\n";
+    if (!opts.autotuneCache.empty()) write_tune_cache(opts, cpu, cores, best, bestMs);
+    return best;
+}
+
+// -------------------- suite de benchmark (--bench-suite) --------------------
+// Matriz declarativa en un fichero de texto: una clave por linea y sus valores
+// separados por comas o espacios ('#' comenta el resto de la linea):
+//   modes   rain,bounce,spiral,nebula     N       2000,20000,200000
+//   res     1024x768,1920x1080            threads 1,2,4,8   (0 = los del runtime)
+//   backend omp,pool,serial               warmup  30        frames 300
+//   window  0|1
+// Se corren todas las combinaciones backend x modo x N x resolucion x hilos en
+// este proceso, una TextRender por escena con dt fijo (--dt / --sim-hz). Las
+// claves que falten toman el valor de la linea de comandos, de donde salen
+// tambien --seed, --kernel, --collide, --speed, --pin y --taskgraph.
+// Frame = update (headless) o update + dibujo + display (window 1, sin vsync
+// ni limite de fps). Los frames de calentamiento no entran en las estadisticas.
+struct BenchSuite {
+    std::vector<Backend> backends;
+    std::vector<MotionMode> modes;
+    std::vector<int> counts;
+    std::vector<std::pair<int, int>> resolutions;
+    std::vector<int> threads;
+    int warmup = 30;
+    int frames = 300;
+    bool window = false;
+};
+
+static bool parse_int(const std::string& s, int& v) {
+    char* end = nullptr;
+    const long x = std::strtol(s.c_str(), &end, 10);
+    if (end == s.c_str() || *end != '\0' || x < INT32_MIN || x > INT32_MAX) return false;
+    v = int(x);
+    return true;
+}
+
+static bool read_bench_suite(const CliOptions& opts, BenchSuite& suite) {
+    std::ifstream in(opts.benchSuitePath);
+    if (!in) { std::cerr << "No pude abrir " << opts.benchSuitePath << "\n"; return false; }
+    std::string line;
+    int lineNo = 0;
+    while (std::getline(in, line)) {
+        ++lineNo;
+        line = line.substr(0, line.find('#'));
+        std::replace(line.begin(), line.end(), ',', ' ');
+        std::istringstream ls(line);
+        std::string key, v;
+        if (!(ls >> key)) continue;
+        std::vector<std::string> values;
+        while (ls >> v) values.push_back(v);
+
+        auto bad = [&](const std::string& what) {
+            std::cerr << opts.benchSuitePath << ':' << lineNo << ": " << what << "\n";
+            return false;
+        };
+        if (values.empty()) return bad(key + " sin valores");
+        int n = 0;
+        if (key == "modes" || key == "mode") {
+            for (const std::string& m : values) {
+                MotionMode mode;
+                if (!parse_mode(m, mode)) return bad("modes {rain|bounce|spiral|nebula}");
+                suite.modes.push_back(mode);
+            }
+        } else if (key == "N") {
+            for (const std::string& x : values) {
+                if (!parse_int(x, n) || n <= 0 || n > 200000) return bad("N 1..200000");
+                suite.counts.push_back(n);
+            }
+        } else if (key == "res") {
+            for (const std::string& r : values) {
+                int w, h;
+                if (!parse_resolution(r, w, h)) return bad("res ANCHOxALTO (160x120..10000x10000)");
+                suite.resolutions.push_back({ w, h });
+            }
+        } else if (key == "threads") {
+            for (const std::string& x : values) {
+                if (!parse_int(x, n) || n < 0 || n > 1024) return bad("threads 0..1024 (0 = runtime)");
+                suite.threads.push_back(n);
+            }
+        } else if (key == "backend" || key == "backends") {
+            for (const std::string& b : values) {
+                Backend backend;
+                if (!parse_backend(b, backend)) return bad("backend {omp|pool|serial}");
+                suite.backends.push_back(backend);
+            }
+        } else if (key == "warmup") {
+            if (!parse_int(values[0], n) || n < 0) return bad("warmup >= 0");
+            suite.warmup = n;
+        } else if (key == "frames") {
+            if (!parse_int(values[0], n) || n <= 0) return bad("frames > 0");
+            suite.frames = n;
+        } else if (key == "window") {
+            if (values[0] != "0" && values[0] != "1") return bad("window 0|1");
+            suite.window = values[0] == "1";
+        } else {
+            return bad("clave desconocida " + key + " (modes|N|res|threads|backend|warmup|frames|window)");
+        }
+    }
+    if (suite.backends.empty()) suite.backends.push_back(opts.forceSequential ? Backend::Serial : opts.backend);
+    if (suite.modes.empty()) suite.modes.push_back(opts.mode);
+    if (suite.counts.empty()) suite.counts.push_back(opts.nChars);
+    if (suite.resolutions.empty()) suite.resolutions.push_back({ opts.width, opts.height });
+    if (suite.threads.empty()) suite.threads.push_back(opts.threads);
+    return true;
+}
 
-    int result = 0;
+// Tiempo de frame (ms) de los frames medidos de una escena. Percentiles por
+// rango mas cercano sobre la muestra ordenada; stddev muestral
+struct FrameStats {
+    double mean = 0.0, stddev = 0.0, p50 = 0.0, p95 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+static FrameStats frame_stats(std::vector<double> ms) {
+    FrameStats st;
+    if (ms.empty()) return st;
+    std::sort(ms.begin(), ms.end());
+    const auto rank = [&](double p) {
+        const std::size_t k = std::size_t(std::ceil(p * double(ms.size())));
+        return ms[std::clamp<std::size_t>(k, 1, ms.size()) - 1];
+    };
+    double sum = 0.0;
+    for (double m : ms) sum += m;
+    st.mean = sum / double(ms.size());
+    double sq = 0.0;
+    for (double m : ms) sq += (m - st.mean) * (m - st.mean);
+    st.stddev = ms.size() > 1 ? std::sqrt(sq / double(ms.size() - 1)) : 0.0;
+    st.p50 = rank(0.50);
+    st.p95 = rank(0.95);
+    st.p99 = rank(0.99);
+    st.max = ms.back();
+    return st;
+}
+
+struct SuiteCase {
+    Backend backend;
+    MotionMode mode;
+    int n, width, height;
+    int threads;  // 0 = los del runtime
+};
 
+struct SuiteResult {
+    int threadsReq = 0, threadsEff = 0;
+    int threadsUsed = 0;  // mayor equipo que corrio algun sitio paralelo en los frames medidos
+    FrameStats frame;
+    double updateMean = 0.0, renderMean = 0.0;
+    std::uint64_t hash = 0;
+};
+
+static SuiteResult run_suite_case(const CliOptions& opts, const BenchSuite& suite,
+                                  const sf::Font& font, const SuiteCase& c, int runtimeThreads) {
+    using clock_t = std::chrono::steady_clock;
+    const int t = c.backend == Backend::Serial ? 1 : (c.threads > 0 ? c.threads : runtimeThreads);
 #ifdef _OPENMP
-    // Ejecuta el bucle principal dentro de región paralela: solo 1 hilo llama a run_loop
-    #pragma omp parallel
-    {
-        #pragma omp single
-        {
-            result = run_loop(opts);
+    omp_set_num_threads(t);
+#endif
+    RenderConfig cfg = make_render_config(opts, !suite.window);
+    cfg.backend = c.backend;
+
+    std::unique_ptr<sf::RenderWindow> window;
+    if (suite.window) {
+        window = std::make_unique<sf::RenderWindow>(sf::VideoMode(c.width, c.height),
+                                                    "Matrix bench-suite", sf::Style::Default,
+                                                    window_context());
+        window->setVerticalSyncEnabled(false);
+    }
+    TextRender renderer(c.n, font, 24, sf::Vector2u(unsigned(c.width), unsigned(c.height)),
+                        c.mode, opts.speed, opts.palette, cfg);
+
+    SuiteResult r;
+    r.threadsEff = effective_threads(renderer);
+    r.threadsReq = c.backend == Backend::Serial ? 1 : (c.threads > 0 ? c.threads : r.threadsEff);
+
+    const float dt = opts.simHz > 0.f ? 1.f / opts.simHz : opts.fixedDt;
+    std::vector<double> frameMs;
+    frameMs.reserve(std::size_t(suite.frames));
+    for (int f = 0; f < suite.warmup + suite.frames; ++f) {
+        const auto t0 = clock_t::now();
+        renderer.update(dt);
+        const auto t1 = clock_t::now();
+        if (window) {
+            sf::Event e;
+            while (window->pollEvent(e)) {}
+            window->clear(sf::Color::Black);
+            renderer.render(*window);
+            window->display();
         }
-        #pragma omp barrier
+        const auto t2 = clock_t::now();
+        if (f < suite.warmup) continue;
+
+        r.updateMean += std::chrono::duration<double, std::milli>(t1 - t0).count();
+        r.renderMean += std::chrono::duration<double, std::milli>(t2 - t1).count();
+        frameMs.push_back(std::chrono::duration<double, std::milli>(t2 - t0).count());
+        for (int s = 0; s < int(ParSite::Count); ++s)
+            r.threadsUsed = std::max(r.threadsUsed, renderer.siteThreads(ParSite(s)));
+    }
+    r.updateMean /= double(suite.frames);
+    r.renderMean /= double(suite.frames);
+    r.frame = frame_stats(std::move(frameMs));
+    r.hash = renderer.stateHash();
+    return r;
+}
+
+static bool open_bench_suite(const CliOptions& opts, std::string& path, std::ofstream& out) {
+    namespace fs = std::filesystem;
+    path = opts.benchSuiteOutPath;
+    if (path.empty()) {
+        std::error_code ec;
+        fs::create_directories("bench", ec);
+        const std::time_t now = std::time(nullptr);
+        char ts[32];
+        std::strftime(ts, sizeof ts, "%Y%m%d_%H%M%S", std::localtime(&now));
+        path = std::string("bench/suite_") + ts + ".csv";
+    }
+    bool newFile = !fs::exists(path);
+    out.open(path, std::ios::app);
+    if (!out) { std::cerr << "No pude abrir " << path << "\n"; return false; }
+    if (newFile) out << "exec,mode,N,width,height,threads_req,threads_eff,threads_used,window,warmup,frames,"
+                        "mean_ms,stddev_ms,p50_ms,p95_ms,p99_ms,max_ms,update_ms,render_ms,state_hash\n";
+    return true;
+}
+
+static int run_bench_suite(const CliOptions& opts) {
+    BenchSuite suite;
+    if (!read_bench_suite(opts, suite)) return EXIT_FAILURE;
+    sf::Font font;
+    if (!font.loadFromFile("assets/fonts/Matrix-MZ4P.ttf")) {
+        std::cerr << "Error cargando fuente.\n";
+        return EXIT_FAILURE;
     }
+    std::string path;
+    std::ofstream out;
+    if (!open_bench_suite(opts, path, out)) return EXIT_FAILURE;
+    if (opts.pipeline || opts.budgetMs > 0.f || opts.autotune)
+        std::cout << "[suite] --pipeline, --budget y --autotune no aplican a --bench-suite\n";
+
+    // Hilos del runtime antes de tocar la ICV (threads 0)
+#ifdef _OPENMP
+    const int runtimeThreads = omp_get_max_threads();
 #else
-    result = run_loop(opts);
+    const int runtimeThreads = std::max(1, int(std::thread::hardware_concurrency()));
+#endif
+
+    // Serial ignora los hilos: una sola escena por combinacion
+    std::vector<SuiteCase> cases;
+    for (Backend b : suite.backends)
+        for (MotionMode m : suite.modes)
+            for (int n : suite.counts)
+                for (const auto& [w, h] : suite.resolutions)
+                    for (std::size_t ti = 0; ti < suite.threads.size(); ++ti) {
+                        if (b == Backend::Serial && ti > 0) break;
+                        cases.push_back({ b, m, std::min(n, w * h), w, h, suite.threads[ti] });
+                    }
+    std::cout << "[suite] " << opts.benchSuitePath << ": " << cases.size() << " escenas, "
+              << suite.warmup << " + " << suite.frames << " frames"
+              << (suite.window ? " con ventana" : " headless") << " -> " << path << '\n';
+
+    for (std::size_t i = 0; i < cases.size(); ++i) {
+        const SuiteCase& c = cases[i];
+        const SuiteResult r = run_suite_case(opts, suite, font, c, runtimeThreads);
+        const char* exec = opts.taskGraph ? "graph" : backendName(c.backend);
+        out << exec << ',' << mode_to_cstr(c.mode) << ',' << c.n << ',' << c.width << ',' << c.height << ','
+            << r.threadsReq << ',' << r.threadsEff << ',' << r.threadsUsed << ','
+            << (suite.window ? 1 : 0) << ',' << suite.warmup << ',' << suite.frames << ','
+            << std::fixed << std::setprecision(4) << r.frame.mean << ',' << r.frame.stddev << ','
+            << r.frame.p50 << ',' << r.frame.p95 << ',' << r.frame.p99 << ',' << r.frame.max << ','
+            << r.updateMean << ',' << r.renderMean << ','
+            << std::hex << r.hash << std::dec << '\n';
+        out.flush();  // una suite larga que se corta deja las escenas ya medidas
+
+        std::cout << "[suite] " << (i + 1) << '/' << cases.size() << ' ' << exec << ' '
+                  << mode_to_cstr(c.mode) << " N=" << c.n << ' ' << c.width << 'x' << c.height
+                  << " hilos=" << r.threadsReq << " (usados " << r.threadsUsed << ")"
+                  << std::fixed << std::setprecision(3) << " p50=" << r.frame.p50
+                  << " p95=" << r.frame.p95 << " p99=" << r.frame.p99 << " max=" << r.frame.max
+                  << " sd=" << r.frame.stddev << " ms\n";
+    }
+    return EXIT_SUCCESS;
+}
+
+static int run_sequential(CliOptions opts) {
+    // Linea base real: backend serial y, si hay grafo, pool de un hilo
+    opts.backend = Backend::Serial;
+#ifdef _OPENMP
+    omp_set_num_threads(1);
 #endif
+    return run_frames(opts);
+}
 
-    return result;
+static int run_parallel(CliOptions opts) {
+#ifdef _OPENMP
+    if (opts.autotune) {
+        const int t = autotune_threads(opts);
+        if (t > 0) opts.threads = t;
+    }
+    if (opts.threads > 0) omp_set_num_threads(opts.threads);
+
+    // run_loop corre en el hilo inicial, fuera de cualquier region: cada
+    // "omp parallel" de TextRender::update forma su equipo completo. (Antes se
+    // envolvia en parallel+single y esas regiones quedaban anidadas, es decir,
+    // serializadas, con el resto del equipo esperando en la barrera.)
+    // El runtime mantiene vivo el pool de hilos entre regiones.
+    std::cout << "Iniciando ejecucion paralela con "
+              << omp_get_max_threads() << " hilos (backend " << backendName(opts.backend) << ").\n";
+#endif
+    return run_frames(opts);
 }
 
 
 int main(int argc, char** argv) {
+    g_processStart = std::chrono::steady_clock::now();
     CliOptions opts;
     if (!parse_cli(argc, argv, opts)) { print_usage(argv[0]); return EXIT_FAILURE; }
+    if (!opts.seedSet) {
+        opts.seed = splitmix64(std::uint64_t(
+            std::chrono::system_clock::now().time_since_epoch().count()));
+    }
+    std::cout << "[rng] semilla=" << opts.seed << " (repetir con --seed " << opts.seed << ")\n";
+    if (!opts.benchSuitePath.empty()) return run_bench_suite(opts);
     return opts.forceSequential ? run_sequential(opts) : run_parallel(opts);
 }
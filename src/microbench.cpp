@@ -0,0 +1,400 @@
+// matrix_microbench: cada fase de update, la carga del OBJ y la proyeccion
+// del modelo medidas aisladas (sin ventana, sin render, sin el resto del frame).
+//
+// Uso: matrix_microbench [--kernels LISTA] [--n LISTA] [--meshes LISTA]
+//                        [--threads LISTA] [--backend omp|pool|serial]
+//                        [--warmup K] [--reps R] [--res WxH] [--seed S] [-o FICHERO]
+//
+// Las fases de TextRender (rain, dashes, bounce, spiral, nebula) barren
+// N x hilos; obj_load y project (codigo serial) barren los tamanos de malla,
+// esferas UV sinteticas de unos V vertices escritas en un directorio temporal.
+// Por caso: K repeticiones de calentamiento y R medidas (obj_load: R/10, al
+// menos 5). Cada fila del CSV lleva media, stddev, min, p50, p95, max (us) y
+// p50 por elemento (ns). Ejecutar desde la raiz (usa la fuente de assets/).
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "CounterRng.h"
+#include "ObjModel.h"
+#include "TextRender.h"
+
+#ifdef _OPENMP
+  #include <omp.h>
+#endif
+
+namespace {
+
+enum class Kernel { Rain, Dashes, Bounce, Spiral, Nebula, ObjLoad, Project };
+
+struct KernelInfo {
+    Kernel kernel;
+    const char* name;
+};
+
+const KernelInfo kKernels[] = {
+    { Kernel::Rain,    "rain" },
+    { Kernel::Dashes,  "dashes" },
+    { Kernel::Bounce,  "bounce" },
+    { Kernel::Spiral,  "spiral" },
+    { Kernel::Nebula,  "nebula" },
+    { Kernel::ObjLoad, "obj_load" },
+    { Kernel::Project, "project" },
+};
+
+const char* kernelName(Kernel k) {
+    for (const KernelInfo& ki : kKernels)
+        if (ki.kernel == k) return ki.name;
+    return "?";
+}
+
+bool isMeshKernel(Kernel k) { return k == Kernel::ObjLoad || k == Kernel::Project; }
+
+struct Options {
+    std::vector<Kernel> kernels;
+    std::vector<int> counts  = { 1000, 10000, 100000 };
+    std::vector<int> meshes  = { 1000, 10000, 100000 };  // vertices aproximados
+    std::vector<int> threads;                             // vacio: 1 y los del runtime
+    Backend backend = Backend::Omp;
+    int warmup = 20;
+    int reps = 100;
+    unsigned width = 1920, height = 1080;
+    std::uint64_t seed = 1;
+    std::string outPath;
+};
+
+// Tiempos de un caso (us): percentiles por rango mas cercano; stddev muestral
+struct Stats {
+    double mean = 0.0, stddev = 0.0, min = 0.0, p50 = 0.0, p95 = 0.0, max = 0.0;
+};
+
+Stats stats(std::vector<double> us) {
+    Stats st;
+    if (us.empty()) return st;
+    std::sort(us.begin(), us.end());
+    const auto rank = [&](double p) {
+        const std::size_t k = std::size_t(std::ceil(p * double(us.size())));
+        return us[std::clamp<std::size_t>(k, 1, us.size()) - 1];
+    };
+    double sum = 0.0;
+    for (double u : us) sum += u;
+    st.mean = sum / double(us.size());
+    double sq = 0.0;
+    for (double u : us) sq += (u - st.mean) * (u - st.mean);
+    st.stddev = us.size() > 1 ? std::sqrt(sq / double(us.size() - 1)) : 0.0;
+    st.min = us.front();
+    st.p50 = rank(0.50);
+    st.p95 = rank(0.95);
+    st.max = us.back();
+    return st;
+}
+
+// Repite f: warmup veces sin medir y reps medidas
+template <class F>
+std::vector<double> timeReps(int warmup, int reps, F&& f) {
+    using clock_t = std::chrono::steady_clock;
+    for (int i = 0; i < warmup; ++i) f();
+    std::vector<double> us;
+    us.reserve(std::size_t(reps));
+    for (int i = 0; i < reps; ++i) {
+        const auto t0 = clock_t::now();
+        f();
+        us.push_back(std::chrono::duration<double, std::micro>(clock_t::now() - t0).count());
+    }
+    return us;
+}
+
+bool parseIntList(const std::string& s, std::vector<int>& out) {
+    out.clear();
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const int v = std::atoi(item.c_str());
+        if (v <= 0) return false;
+        out.push_back(v);
+    }
+    return !out.empty();
+}
+
+bool parseKernels(const std::string& s, std::vector<Kernel>& out) {
+    out.clear();
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        const auto it = std::find_if(std::begin(kKernels), std::end(kKernels),
+                                     [&](const KernelInfo& ki) { return item == ki.name; });
+        if (it == std::end(kKernels)) return false;
+        out.push_back(it->kernel);
+    }
+    return !out.empty();
+}
+
+void usage(const char* prog) {
+    std::fprintf(stderr,
+        "Uso: %s [--kernels rain,dashes,bounce,spiral,nebula,obj_load,project]\n"
+        "       [--n N1,N2,..] [--meshes V1,V2,..] [--threads T1,T2,..]\n"
+        "       [--backend omp|pool|serial] [--warmup K] [--reps R] [--res WxH]\n"
+        "       [--seed S] [-o FICHERO]\n", prog);
+}
+
+bool parseArgs(int argc, char** argv, Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        const std::string a = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (a == "--kernels" && hasValue) {
+            if (!parseKernels(argv[++i], opt.kernels)) return false;
+        } else if (a == "--n" && hasValue) {
+            if (!parseIntList(argv[++i], opt.counts)) return false;
+        } else if (a == "--meshes" && hasValue) {
+            if (!parseIntList(argv[++i], opt.meshes)) return false;
+        } else if (a == "--threads" && hasValue) {
+            if (!parseIntList(argv[++i], opt.threads)) return false;
+        } else if (a == "--backend" && hasValue) {
+            const std::string b = argv[++i];
+            if      (b == "omp")                  opt.backend = Backend::Omp;
+            else if (b == "pool")                 opt.backend = Backend::Pool;
+            else if (b == "serial" || b == "seq") opt.backend = Backend::Serial;
+            else return false;
+        } else if (a == "--warmup" && hasValue) {
+            opt.warmup = std::atoi(argv[++i]);
+            if (opt.warmup < 0) return false;
+        } else if (a == "--reps" && hasValue) {
+            opt.reps = std::atoi(argv[++i]);
+            if (opt.reps < 1) return false;
+        } else if (a == "--res" && hasValue) {
+            unsigned w = 0, h = 0;
+            if (std::sscanf(argv[++i], "%ux%u", &w, &h) != 2 || w == 0 || h == 0) return false;
+            opt.width = w;
+            opt.height = h;
+        } else if (a == "--seed" && hasValue) {
+            if (!parseSeed(argv[++i], opt.seed)) return false;
+        } else if (a == "-o" && hasValue) {
+            opt.outPath = argv[++i];
+        } else {
+            return false;
+        }
+    }
+    if (opt.kernels.empty())
+        for (const KernelInfo& ki : kKernels) opt.kernels.push_back(ki.kernel);
+    return true;
+}
+
+// Esfera UV de unos `vertices` vertices (anillos x segmentos, caras de 4)
+bool writeSphereObj(const std::string& path, int vertices) {
+    const int rings = std::max(2, int(std::sqrt(double(vertices) / 2.0)));
+    const int segs = std::max(3, vertices / rings);
+    std::ofstream out(path);
+    if (!out) return false;
+    const double pi = 3.14159265358979323846;
+    char line[96];
+    for (int r = 0; r < rings; ++r) {
+        const double phi = pi * (r + 0.5) / rings;
+        for (int s = 0; s < segs; ++s) {
+            const double th = 2.0 * pi * s / segs;
+            std::snprintf(line, sizeof line, "v %.6f %.6f %.6f\n",
+                          std::sin(phi) * std::cos(th), std::cos(phi), std::sin(phi) * std::sin(th));
+            out << line;
+        }
+    }
+    for (int r = 0; r + 1 < rings; ++r)
+        for (int s = 0; s < segs; ++s) {
+            const int a = r * segs + s + 1, b = r * segs + (s + 1) % segs + 1;
+            out << "f " << a << ' ' << b << ' ' << (b + segs) << ' ' << (a + segs) << '\n';
+        }
+    return bool(out);
+}
+
+MotionMode sceneMode(Kernel k) {
+    switch (k) {
+    case Kernel::Bounce: return MotionMode::Bounce;
+    case Kernel::Spiral: return MotionMode::Spiral;
+    case Kernel::Nebula: return MotionMode::Nebula;
+    default:             return MotionMode::Rain;
+    }
+}
+
+TextRender::Phase scenePhase(Kernel k) {
+    switch (k) {
+    case Kernel::Dashes: return TextRender::Phase::Dashes;
+    case Kernel::Bounce: return TextRender::Phase::Bounce;
+    case Kernel::Spiral: return TextRender::Phase::Spiral;
+    case Kernel::Nebula: return TextRender::Phase::Nebula;
+    default:             return TextRender::Phase::Rain;
+    }
+}
+
+ParSite phaseSite(Kernel k) {
+    switch (k) {
+    case Kernel::Rain:   return ParSite::RainCols;
+    case Kernel::Dashes: return ParSite::DashDots;
+    default:             return ParSite::Particles;
+    }
+}
+
+struct Row {
+    Kernel kernel;
+    int n = 0;                  // N pedido (escena) o vertices de la malla
+    int items = 0;              // elementos por llamada: columnas, puntos, particulas, vertices
+    std::size_t meshV = 0, meshE = 0;
+    int threadsReq = 1, threadsUsed = 1;
+    int warmup = 0, reps = 0;
+    Stats st;
+};
+
+void writeRow(std::ofstream& out, const Options& opt, const Row& r) {
+    const double perItem = r.items > 0 ? 1000.0 * r.st.p50 / double(r.items) : 0.0;
+    char line[320];
+    std::snprintf(line, sizeof line,
+        "%s,%s,%d,%d,%zu,%zu,%d,%d,%d,%d,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n",
+        kernelName(r.kernel), isMeshKernel(r.kernel) ? "serial" : backendName(opt.backend),
+        r.n, r.items, r.meshV, r.meshE, r.threadsReq, r.threadsUsed, r.warmup, r.reps,
+        r.st.mean, r.st.stddev, r.st.min, r.st.p50, r.st.p95, r.st.max, perItem);
+    out << line;
+    out.flush();  // una corrida que se corta deja los casos ya medidos
+
+    std::printf("%-8s N=%-8d elem=%-8d", kernelName(r.kernel), r.n, r.items);
+    if (isMeshKernel(r.kernel)) std::printf(" aristas=%-8zu", r.meshE);
+    else                        std::printf(" hilos=%d (usados %d)", r.threadsReq, r.threadsUsed);
+    std::printf("  p50=%.2f p95=%.2f min=%.2f sd=%.2f us  %.2f ns/elem\n",
+                r.st.p50, r.st.p95, r.st.min, r.st.stddev, perItem);
+}
+
+// Elementos que recorre la fase en la escena (lo que divide el ns/elem): en
+// rain y dashes dependen del ancho, no de N
+int phaseItems(Kernel k, const TextRender& renderer) {
+    return int(renderer.siteRun(phaseSite(k)).trip);
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) { usage(argv[0]); return 2; }
+
+#ifdef _OPENMP
+    const int runtimeThreads = omp_get_max_threads();
+#else
+    const int runtimeThreads = std::max(1, int(std::thread::hardware_concurrency()));
+#endif
+    if (opt.threads.empty()) {
+        opt.threads.push_back(1);
+        if (runtimeThreads > 1) opt.threads.push_back(runtimeThreads);
+    }
+    if (opt.backend == Backend::Serial) opt.threads.assign(1, 1);
+
+    namespace fs = std::filesystem;
+    std::error_code ec;
+    if (opt.outPath.empty()) {
+        fs::create_directories("bench", ec);
+        const std::time_t now = std::time(nullptr);
+        char ts[32];
+        std::strftime(ts, sizeof ts, "%Y%m%d_%H%M%S", std::localtime(&now));
+        opt.outPath = std::string("bench/micro_") + ts + ".csv";
+    }
+    const bool newFile = !fs::exists(opt.outPath);
+    std::ofstream out(opt.outPath, std::ios::app);
+    if (!out) { std::fprintf(stderr, "No pude abrir %s\n", opt.outPath.c_str()); return 1; }
+    if (newFile) out << "kernel,backend,N,items,mesh_v,mesh_e,threads_req,threads_used,warmup,reps,"
+                        "mean_us,stddev_us,min_us,p50_us,p95_us,max_us,ns_per_item\n";
+    std::printf("[micro] %d + %d repeticiones por caso -> %s\n", opt.warmup, opt.reps, opt.outPath.c_str());
+
+    const float dt = 1.f / 60.f;
+    const bool needFont = std::any_of(opt.kernels.begin(), opt.kernels.end(),
+                                      [](Kernel k) { return !isMeshKernel(k); });
+    sf::Font font;
+    if (needFont && !font.loadFromFile("assets/fonts/Matrix-MZ4P.ttf")) {
+        std::fprintf(stderr, "No se encontro assets/fonts/Matrix-MZ4P.ttf. Ejecuta desde la raiz.\n");
+        return 1;
+    }
+
+    // Fases de update: una escena por (fase, N, hilos); el backend toma los
+    // hilos de la ICV de OpenMP al construirse
+    for (Kernel k : opt.kernels) {
+        if (isMeshKernel(k)) continue;
+        for (int n : opt.counts)
+            for (int t : opt.threads) {
+#ifdef _OPENMP
+                omp_set_num_threads(t);
+#endif
+                RenderConfig cfg;
+                cfg.headless = true;
+                cfg.seed = opt.seed;
+                cfg.backend = opt.backend;
+                TextRender renderer(n, font, 24, sf::Vector2u(opt.width, opt.height),
+                                    sceneMode(k), 160.f, Palette::Mono, cfg);
+                const TextRender::Phase phase = scenePhase(k);
+                Row r;
+                r.kernel = k;
+                r.threadsReq = t;
+                r.threadsUsed = 0;
+                std::vector<double> us = timeReps(opt.warmup, opt.reps, [&] {
+                    renderer.updatePhase(phase, dt);
+                    r.threadsUsed = std::max(r.threadsUsed, renderer.siteThreads(phaseSite(k)));
+                });
+                r.n = n;
+                r.items = phaseItems(k, renderer);
+                r.warmup = opt.warmup;
+                r.reps = opt.reps;
+                r.st = stats(std::move(us));
+                writeRow(out, opt, r);
+            }
+    }
+
+    // Malla: carga y rotacion + proyeccion de drawProjected (sin armar lineas
+    // ni dibujar); ambas en el hilo llamador
+    const bool anyMesh = std::any_of(opt.kernels.begin(), opt.kernels.end(), isMeshKernel);
+    const fs::path tmpDir = fs::temp_directory_path(ec) / "matrix_microbench";
+    if (anyMesh) fs::create_directories(tmpDir, ec);
+    for (int v : opt.meshes) {
+        if (!anyMesh) break;
+        const std::string path = (tmpDir / ("sphere_" + std::to_string(v) + ".obj")).string();
+        if (!writeSphereObj(path, v)) { std::fprintf(stderr, "No pude escribir %s\n", path.c_str()); return 1; }
+        ObjModel model;
+        if (!model.loadFromOBJ(path)) { std::fprintf(stderr, "No pude cargar %s\n", path.c_str()); return 1; }
+
+        for (Kernel k : opt.kernels) {
+            if (!isMeshKernel(k)) continue;
+            Row r;
+            r.kernel = k;
+            r.n = v;
+            r.items = int(model.vertexCount());
+            r.meshV = model.vertexCount();
+            r.meshE = model.edgeCount();
+            std::vector<double> us;
+            if (k == Kernel::ObjLoad) {
+                // Cada carga lee y analiza el fichero entero: menos repeticiones
+                r.warmup = std::min(opt.warmup, 3);
+                r.reps = std::max(5, opt.reps / 10);
+                ObjModel m;
+                us = timeReps(r.warmup, r.reps, [&] { m.loadFromOBJ(path); });
+            } else {
+                r.warmup = opt.warmup;
+                r.reps = opt.reps;
+                float angle = 0.f;
+                const sf::Vector2f center(opt.width * 0.5f, opt.height * 0.5f);
+                const float scale = 0.35f * float(std::min(opt.width, opt.height));
+                us = timeReps(opt.warmup, opt.reps, [&] {
+                    model.project(center, scale, angle);
+                    angle += 0.01f;
+                });
+            }
+            r.st = stats(std::move(us));
+            writeRow(out, opt, r);
+        }
+        fs::remove(path, ec);
+    }
+    if (anyMesh) fs::remove(tmpDir, ec);
+    return 0;
+}